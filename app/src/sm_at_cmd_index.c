@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sm_at_cmd_index.h"
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <zephyr/sys/util.h>
+
+/* Characters that end the base command in an AT command. */
+#define AT_CMD_BASE_END "=?;\r\n"
+
+static int base_cmp(const char *a, size_t a_len, const char *b, size_t b_len)
+{
+	int ret = strncasecmp(a, b, MIN(a_len, b_len));
+
+	if (ret == 0) {
+		ret = (int)a_len - (int)b_len;
+	}
+
+	return ret;
+}
+
+/* Lookup order of table positions i and j. */
+static int entry_cmp(const struct sm_at_cmd_index *index, uint8_t i, uint8_t j)
+{
+	const struct nrf_modem_at_cmd_custom *a = &index->table[i];
+	const struct nrf_modem_at_cmd_custom *b = &index->table[j];
+	int ret;
+
+	ret = base_cmp(a->cmd, index->base_len[i], b->cmd, index->base_len[j]);
+	if (ret == 0) {
+		/* The more specific filter first. */
+		ret = (int)b->cmd_strlen - (int)a->cmd_strlen;
+	}
+	if (ret == 0) {
+		ret = (int)i - (int)j;
+	}
+
+	return ret;
+}
+
+int sm_at_cmd_index_build(struct sm_at_cmd_index *index,
+			  const struct nrf_modem_at_cmd_custom *table, size_t count)
+{
+	if (count > SM_AT_CMD_INDEX_MAX) {
+		index->count = 0;
+		return -E2BIG;
+	}
+
+	index->table = table;
+	index->count = count;
+
+	for (size_t i = 0; i < count; i++) {
+		index->base_len[i] = strcspn(table[i].cmd, AT_CMD_BASE_END);
+		index->order[i] = i;
+	}
+
+	/* Insertion sort, the table is small and this is done once. */
+	for (size_t i = 1; i < count; i++) {
+		uint8_t pos = index->order[i];
+		size_t j = i;
+
+		while (j > 0 && entry_cmp(index, index->order[j - 1], pos) > 0) {
+			index->order[j] = index->order[j - 1];
+			j--;
+		}
+		index->order[j] = pos;
+	}
+
+	return 0;
+}
+
+const struct nrf_modem_at_cmd_custom *sm_at_cmd_index_find(const struct sm_at_cmd_index *index,
+							   const char *at_cmd)
+{
+	size_t base_len = strcspn(at_cmd, AT_CMD_BASE_END);
+	size_t low = 0;
+	size_t high = index->count;
+
+	/* Find the first entry with the same base command. */
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		uint8_t pos = index->order[mid];
+
+		if (base_cmp(index->table[pos].cmd, index->base_len[pos], at_cmd, base_len) < 0) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	for (; low < index->count; low++) {
+		const struct nrf_modem_at_cmd_custom *entry = &index->table[index->order[low]];
+
+		if (index->base_len[index->order[low]] != base_len ||
+		    strncasecmp(entry->cmd, at_cmd, base_len) != 0) {
+			break;
+		}
+		if (strncasecmp(entry->cmd, at_cmd, entry->cmd_strlen) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
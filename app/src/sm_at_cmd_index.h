@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SM_AT_CMD_INDEX_
+#define SM_AT_CMD_INDEX_
+
+/** @file sm_at_cmd_index.h
+ *
+ * @brief Lookup index for the custom AT commands of Serial Modem
+ * @{
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <nrf_modem_at.h>
+
+/** Maximum amount of custom AT commands in the index. */
+#define SM_AT_CMD_INDEX_MAX 255
+
+/**
+ * @brief Index of custom AT commands.
+ *
+ * The entries are ordered by their base command (the part before '=' or '?'), so that a
+ * command is resolved with a binary search instead of a walk through the whole table.
+ */
+struct sm_at_cmd_index {
+	const struct nrf_modem_at_cmd_custom *table;
+	size_t count;
+	/* Table positions in lookup order. */
+	uint8_t order[SM_AT_CMD_INDEX_MAX];
+	/* Base command lengths by table position. */
+	uint8_t base_len[SM_AT_CMD_INDEX_MAX];
+};
+
+/**
+ * @brief Build the index for a table of custom AT commands.
+ *
+ * Entries with the same base command are ordered from the longest filter to the shortest,
+ * and in table order for equal lengths.
+ *
+ * @param index Index to build.
+ * @param table Custom AT commands.
+ * @param count Amount of custom AT commands.
+ *
+ * @retval 0 on success. -E2BIG if there are too many commands.
+ */
+int sm_at_cmd_index_build(struct sm_at_cmd_index *index,
+			  const struct nrf_modem_at_cmd_custom *table, size_t count);
+
+/**
+ * @brief Find the custom AT command that handles an AT command.
+ *
+ * The base command must match exactly, so that for example AT#XSEND does not handle
+ * AT#XSENDTO. The whole filter must be a prefix of the AT command. Letter case is ignored.
+ *
+ * @param index Index built with @ref sm_at_cmd_index_build.
+ * @param at_cmd AT command.
+ *
+ * @retval Custom AT command or NULL if the AT command is not a custom one.
+ */
+const struct nrf_modem_at_cmd_custom *sm_at_cmd_index_find(const struct sm_at_cmd_index *index,
+							   const char *at_cmd);
+
+/** @} */
+
+#endif /* SM_AT_CMD_INDEX_ */
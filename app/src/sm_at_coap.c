@@ -147,21 +147,6 @@ static void coap_send_status(struct coap_request *req)
 		    (int)req->bytes_sent);
 }
 
-static void coap_data_send_hex(struct modem_pipe *pipe, const uint8_t *buf, size_t len)
-{
-	char hex_buf[257];
-	size_t chunk = (sizeof(hex_buf) - 1) / 2;
-	size_t done = 0;
-
-	while (done < len) {
-		size_t n = MIN(chunk, len - done);
-		size_t sz = bin2hex(buf + done, n, hex_buf, sizeof(hex_buf));
-
-		data_send(pipe, hex_buf, sz);
-		done += n;
-	}
-}
-
 static void coap_send_data(struct coap_request *req, const uint8_t *payload, size_t payload_len)
 {
 	if (!payload || payload_len == 0) {
@@ -176,7 +161,7 @@ static void coap_send_data(struct coap_request *req, const uint8_t *payload, siz
 		    (int)req->bytes_sent, (int)payload_len);
 	req->bytes_sent += payload_len;
 	if (req->hex_rx) {
-		coap_data_send_hex(req->pipe, payload, payload_len);
+		data_send_hex(req->pipe, payload, payload_len);
 	} else {
 		data_send(req->pipe, payload, payload_len);
 	}
@@ -404,7 +389,7 @@ static int parse_option_value(const char *str, size_t str_len,
 		if (hex_len == 0 || (hex_len & 1U)) {
 			return -EINVAL;
 		}
-		n = hex2bin(hex, hex_len, out, out_max);
+		n = util_hex2bin(hex, hex_len, out, out_max);
 		if (n == 0) {
 			return -EINVAL;
 		}
@@ -915,7 +900,7 @@ STATIC int handle_at_coap_data(enum at_parser_cmd_type cmd_type, struct at_parse
 			 (int)send_len);
 		req->bytes_sent += send_len;
 		if (req->hex_rx) {
-			coap_data_send_hex(req->pipe, req->rx_buf, send_len);
+			data_send_hex(req->pipe, req->rx_buf, send_len);
 		} else {
 			data_send(req->pipe, req->rx_buf, send_len);
 		}
@@ -11,8 +11,12 @@
 #include "sm_ctrl_pin.h"
 #include "sm_at_dfu.h"
 #include "sm_ppp.h"
+#include "sm_cgev.h"
 #include "sm_at_socket.h"
 #include "sm_cmux.h"
+#if defined(CONFIG_SM_AT_CMD_INDEX)
+#include "sm_at_cmd_index.h"
+#endif
 #include <assert.h>
 #include <stdio.h>
 #include <string.h>
@@ -37,6 +41,16 @@ LOG_MODULE_REGISTER(sm_at_host, CONFIG_SM_LOG_LEVEL);
 #define URC_RETRY_DELAY   K_MSEC(100)
 #define AT_BUF_MIN_SIZE   128
 #define AT_BUF_MAX_SIZE   8192
+/* Amount of data drained from the pipe per receive call. Matches one UART RX slab block. */
+#define AT_PIPE_RX_CHUNK_SIZE CONFIG_SM_UART_RX_BUF_SIZE
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+/* The input after a command that starts executing is queued, so a receive call must not
+ * return more than fits in the empty queue.
+ */
+#define AT_PIPE_RX_LEN MIN(AT_PIPE_RX_CHUNK_SIZE, CONFIG_SM_AT_CMD_QUEUE_SIZE)
+#else
+#define AT_PIPE_RX_LEN AT_PIPE_RX_CHUNK_SIZE
+#endif
 #define AT_XDFU_INIT_CMD  "AT#XDFUINIT"
 #define AT_XDFU_WRITE_CMD "AT#XDFUWRITE"
 #define AT_XDFU_APPLY_CMD "AT#XDFUAPPLY"
@@ -68,13 +82,16 @@ struct data_mode {
 	int handler_result;
 	uint16_t time_limit; /* Time limit for idle period before sending in ms. */
 	size_t data_len;     /* Expected data length in data mode. */
+	bool zero_copy;      /* Pass data to the handler without buffering. */
 };
 
-/** Buffered URC message targeting a specific pipe */
-struct urc_msg {
-	sys_snode_t node;
-	char urc[];
-};
+/** Response buffers owned by an AT host instance. */
+struct sm_at_rsp_buf {
+	/* Modem response to an AT command, with room for a leading CRLF. */
+	uint8_t cmd[CONFIG_SM_AT_BUF_SIZE + 1];
+	/* Formatted responses and URCs. */
+	char fmt[SM_AT_MAX_RSP_LEN];
+} __aligned(4);
 
 /* Forward declarations */
 static void idle_timer_handler(struct k_timer *timer);
@@ -83,7 +100,7 @@ static void raw_send_scheduled(struct k_work *work);
 static void at_pipe_rx_work_fn(struct k_work *work);
 static void at_pipe_event_handler(struct modem_pipe *pipe, enum modem_pipe_event event,
 				  void *user_data);
-static size_t sm_at_receive(struct sm_at_host_ctx *ctx, uint8_t c);
+static size_t sm_at_receive(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len);
 static void sm_at_host_work_fn(struct k_work *work);
 static enum sm_operation_mode get_sm_mode(struct sm_at_host_ctx *ctx);
 static bool sm_at_ctx_check(struct sm_at_host_ctx *ctx);
@@ -119,7 +136,7 @@ static void flush_pipe_urcs(struct sm_at_host_ctx *ctx);
  * Idle: modem_pipe_attach(pipe, null_pipe_handler, NULL)
  * Idle -up-> Create: MODEM_PIPE_EVENT_OPENED
  * }
- * Destroy: free(ctx->data_rb_buf)\nfree(ctx->at_buf)\nfree(ctx)
+ * Destroy: free(ctx->data_rb_buf)\nfree(ctx->at_buf)\nk_mem_slab_free(ctx->rsp)\nfree(ctx)
  * Destroy --> [*]
  * @enduml
  *
@@ -137,18 +154,31 @@ struct sm_at_host_ctx {
 	struct data_mode data_mode;
 
 	/* Data buffers */
+	uint8_t rx_buf[AT_PIPE_RX_CHUNK_SIZE];
 	uint8_t *at_buf;
 	size_t at_buf_size;
+	/* Commands in a row that did not need the grown AT command buffer */
+	uint8_t at_buf_short_cmds;
 	struct ring_buf data_rb;
 	uint8_t *data_rb_buf;
 	uint8_t quit_str_match;
 	struct k_mutex mutex_data;
+	struct sm_at_rsp_buf *rsp;
+	struct k_mutex mutex_rsp;
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+	/* Input received while a command is executing, processed in order when it is done. */
+	struct ring_buf cmd_queue;
+	uint8_t cmd_queue_buf[CONFIG_SM_AT_CMD_QUEUE_SIZE];
+#endif
 
 	/* Work items and timers */
 	struct k_work rx_work;
 	struct k_work raw_send_scheduled_work;
 	struct k_timer data_inactivity_timer;
 	struct k_timer idle_timer;
+	/* Timers are re-armed lazily from these, in k_uptime_get_32() time */
+	atomic_t data_last_rx;
+	atomic_t idle_deadline;
 
 	/* AT command reception state (for cmd_rx_handler) */
 	bool inside_quotes;
@@ -165,7 +195,12 @@ struct sm_at_host_ctx {
 	bool echo_enabled;
 
 	sys_slist_t idle_work_list;
-	sys_slist_t buffered_urcs;
+
+	/* URCs sent to this pipe with urc_send_to(), flushed together when idle */
+	struct ring_buf urc_rb;
+	uint8_t urc_rb_buf[CONFIG_SM_PIPE_URC_BUFFER_SIZE];
+	uint32_t urc_dropped;
+	struct k_mutex mutex_urc;
 
 	/* Asynchronous poll context for sockets */
 	struct async_poll_ctx poll_ctx;
@@ -188,11 +223,25 @@ K_MSGQ_DEFINE(sm_at_host_msgq, sizeof(struct sm_at_host_msg), 10, 1);
 static sys_slist_t instance_list = SYS_SLIST_STATIC_INIT(instance_list);
 static K_WORK_DEFINE(sm_at_host_work, sm_at_host_work_fn);
 RING_BUF_DECLARE(urc_buf, CONFIG_SM_URC_BUFFER_SIZE);
-static uint8_t sm_response_buf[CONFIG_SM_AT_BUF_SIZE + 1];
+/* One set of response buffers for each AT host instance. */
+#if defined(CONFIG_SM_CMUX)
+#define AT_HOST_RSP_BUF_COUNT CONFIG_SM_CMUX_CHANNEL_COUNT
+#else
+#define AT_HOST_RSP_BUF_COUNT 1
+#endif
+K_MEM_SLAB_DEFINE_STATIC(rsp_buf_slab, sizeof(struct sm_at_rsp_buf), AT_HOST_RSP_BUF_COUNT, 4);
 /* Current executing context (set by entry points) */
 static struct sm_at_host_ctx *current_ctx;
 static struct k_spinlock sm_at_host_lock;
 
+/* Heap usage of the AT command buffers of all instances */
+static struct {
+	atomic_t bytes;
+	atomic_t peak;
+	atomic_t grows;
+	atomic_t shrinks;
+} at_buf_stats;
+
 #if defined(CONFIG_SM_CMUX)
 static uint8_t urc_channel;
 #endif /* CONFIG_SM_CMUX */
@@ -413,21 +462,92 @@ static void check_idle_timer(struct sm_at_host_ctx *ctx, bool reschedule)
 	if (!ctx) {
 		return;
 	}
-	if (reschedule || k_timer_remaining_ticks(&ctx->idle_timer) == 0) {
+	k_ticks_t remaining = k_timer_remaining_ticks(&ctx->idle_timer);
+
+	if (reschedule || remaining == 0) {
 		k_timeout_t delay = ctx->echo_enabled && (reschedule || ctx->at_cmd_len != 0)
 					    ? K_MSEC(CONFIG_SM_URC_DELAY_WITH_INCOMPLETE_ECHO_MS)
 					    : URC_RETRY_DELAY;
 
-		k_timer_start(&ctx->idle_timer, delay, K_NO_WAIT);
+		atomic_set(&ctx->idle_deadline, k_uptime_get_32() + k_ticks_to_ms_ceil32(delay.ticks));
+		/* A running timer is extended by its handler, restart only to shorten it. */
+		if (remaining == 0 || remaining > delay.ticks) {
+			k_timer_start(&ctx->idle_timer, delay, K_NO_WAIT);
+		}
+	}
+}
+
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+/* Queue the input that arrives while a command is executing. */
+static void cmd_queue_fill(struct sm_at_host_ctx *ctx, struct modem_pipe *pipe)
+{
+	uint8_t *data;
+	uint32_t space;
+	int ret;
+
+	do {
+		space = ring_buf_put_claim(&ctx->cmd_queue, &data, sizeof(ctx->cmd_queue_buf));
+		if (space == 0) {
+			/* Leave the rest in the pipe until the queue is processed. */
+			ring_buf_put_finish(&ctx->cmd_queue, 0);
+			break;
+		}
+		ret = modem_pipe_receive(pipe, data, space);
+		if (ret < 0) {
+			LOG_ERR("Pipe receive failed: %d (ctx %p, pipe %p)", ret, (void *)ctx,
+				(void *)pipe);
+			ret = 0;
+		}
+		ring_buf_put_finish(&ctx->cmd_queue, ret);
+	} while (ret > 0);
+}
+
+/* Process the queued input. Returns false if processing stopped because a command is
+ * executing or the pipe was changed.
+ */
+static bool cmd_queue_process(struct sm_at_host_ctx *ctx, struct modem_pipe *pipe)
+{
+	uint8_t *data;
+	uint32_t len;
+	size_t processed;
+
+	while (!ring_buf_is_empty(&ctx->cmd_queue)) {
+		len = ring_buf_get_claim(&ctx->cmd_queue, &data, sizeof(ctx->cmd_queue_buf));
+		processed = sm_at_receive(ctx, data, len);
+		ring_buf_get_finish(&ctx->cmd_queue, processed);
+		if (atomic_ptr_get(&ctx->pipe) != pipe) {
+			LOG_WRN("Pipe changed, dropped %u queued bytes",
+				ring_buf_size_get(&ctx->cmd_queue));
+			ring_buf_reset(&ctx->cmd_queue);
+			return false;
+		}
+		if (processed < len) {
+			return false;
+		}
 	}
+
+	return true;
 }
 
+/* Queue the data that was not processed because a command is executing. The queue is
+ * empty when the data was received, and AT_PIPE_RX_LEN makes the data fit in it.
+ */
+static void cmd_queue_put(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
+{
+	uint32_t queued = ring_buf_put(&ctx->cmd_queue, buf, len);
+
+	if (queued < len) {
+		LOG_ERR("AT command queue full, dropped %zu bytes", len - queued);
+	}
+}
+#endif
+
 /* Process received data from pipe */
 static void at_pipe_rx_work_fn(struct k_work *work)
 {
 	struct sm_at_host_ctx *ctx = CONTAINER_OF(work, struct sm_at_host_ctx, rx_work);
 	int ret;
-	uint8_t rx_buf;
+	size_t processed;
 
 	if (!sm_at_ctx_check(ctx)) {
 		LOG_ERR("AT pipe RX work: context destroyed");
@@ -443,15 +563,56 @@ static void at_pipe_rx_work_fn(struct k_work *work)
 
 	/* Do not parse more commands, if we are still executing */
 	if (atomic_get(&ctx->executing_lock) > 0) {
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+		cmd_queue_fill(ctx, pipe);
+#endif
 		return;
 	}
 
 	/* Set as current context */
 	sm_at_host_set_current_ctx(ctx);
 
-	/* Read data from ctx->pipe */
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+	/* Commands that were received while the previous one was executing go first. */
+	if (!cmd_queue_process(ctx, pipe)) {
+		if (atomic_ptr_get(&ctx->pipe) == pipe) {
+			cmd_queue_fill(ctx, pipe);
+		}
+		sm_at_host_set_current_ctx(NULL);
+		return;
+	}
+#endif
+
+#if defined(CONFIG_SM_DATAMODE_ZERO_COPY)
+	if (pipe == sm_uart_pipe_get()) {
+		const uint8_t *data;
+
+		/* Process the data in place in the UART receive buffers. */
+		do {
+			ret = sm_uart_rx_claim(&data);
+			if (ret <= 0) {
+				break;
+			}
+			processed = sm_at_receive(ctx, data, ret);
+			/* Unprocessed data is left for the new pipe user. */
+			sm_uart_rx_finish(processed);
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+			if (atomic_get(&ctx->executing_lock) > 0 &&
+			    atomic_ptr_get(&ctx->pipe) == pipe) {
+				cmd_queue_fill(ctx, pipe);
+				break;
+			}
+#endif
+		} while (atomic_ptr_get(&ctx->pipe) == pipe);
+
+		sm_at_host_set_current_ctx(NULL);
+		return;
+	}
+#endif
+
+	/* Read data from ctx->pipe, a block at a time */
 	do {
-		ret = modem_pipe_receive(pipe, &rx_buf, sizeof(rx_buf));
+		ret = modem_pipe_receive(pipe, ctx->rx_buf, AT_PIPE_RX_LEN);
 		if (ret < 0) {
 			LOG_ERR("Pipe receive failed: %d (ctx %p, pipe %p)", ret, (void *)ctx,
 				(void *)pipe);
@@ -460,7 +621,22 @@ static void at_pipe_rx_work_fn(struct k_work *work)
 
 		if (ret > 0) {
 			/* Process received AT data */
-			sm_at_receive(ctx, rx_buf);
+			processed = sm_at_receive(ctx, ctx->rx_buf, ret);
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+			if (atomic_get(&ctx->executing_lock) > 0 &&
+			    atomic_ptr_get(&ctx->pipe) == pipe) {
+				cmd_queue_put(ctx, ctx->rx_buf + processed, ret - processed);
+				cmd_queue_fill(ctx, pipe);
+				break;
+			}
+#endif
+			if (processed < (size_t)ret) {
+				/* The pipe was switched while processing. The remaining data was
+				 * received before the switch was acknowledged, so it is not meant
+				 * for the new pipe user.
+				 */
+				LOG_WRN("Pipe changed, dropped %d bytes", ret - (int)processed);
+			}
 		}
 	} while (ret > 0 && atomic_ptr_get(&ctx->pipe) == pipe);
 
@@ -636,7 +812,7 @@ static bool set_sm_mode(struct sm_at_host_ctx *ctx, enum sm_operation_mode mode)
 
 	if (ctx->at_mode == SM_AT_COMMAND_MODE) {
 		if (mode == SM_DATA_MODE) {
-			if (ctx->data_rb_buf == NULL) {
+			if (ctx->data_rb_buf == NULL && !ctx->data_mode.zero_copy) {
 				LOG_DBG("Allocating data mode buffer of size %d",
 					CONFIG_SM_DATAMODE_BUF_SIZE);
 				ctx->data_rb_buf = malloc(CONFIG_SM_DATAMODE_BUF_SIZE);
@@ -688,6 +864,7 @@ static bool exit_datamode(struct sm_at_host_ctx *ctx)
 		}
 		ctx->data_mode.handler = NULL;
 		ctx->data_mode.data_len = 0;
+		ctx->data_mode.zero_copy = false;
 		ctx->quit_str_match = 0;
 
 		k_mutex_lock(&ctx->mutex_data, K_FOREVER);
@@ -719,6 +896,11 @@ static void raw_send(uint8_t flags)
 	uint8_t *data = NULL;
 	struct sm_at_host_ctx *ctx = sm_at_host_get_current();
 
+	if (ctx->data_rb_buf == NULL) {
+		/* Nothing is buffered in zero-copy data mode. */
+		return;
+	}
+
 	do {
 		/* ring_buf_get_claim() might not return full size.
 		 * If we have more data in the buffer, set the MORE_DATA flag.
@@ -784,6 +966,47 @@ static void write_data_buf(const uint8_t *buf, size_t len)
 	}
 }
 
+/* Lock mutex_data, before calling. Passes data to the handler without buffering. */
+static void raw_send_direct(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
+{
+	bool retry = true;
+	int ret;
+
+	while (len > 0 && get_sm_mode(ctx) == SM_DATA_MODE) {
+		if (!ctx->data_mode.handler) {
+			LOG_ERR("No handler. Dropped %zu bytes", len);
+			return;
+		}
+
+		LOG_HEXDUMP_DBG(buf, MIN(len, HEXDUMP_LIMIT), "RX");
+		ret = ctx->data_mode.handler(DATAMODE_SEND, buf, len, SM_DATAMODE_FLAGS_NONE);
+		if (ret < 0 || (ret == 0 && !retry)) {
+			/* Exit data mode on send failure. Further data is dropped. */
+			LOG_ERR("Send failed: %d, Dropped: %zu bytes", ret, len);
+			exit_datamode_handler(ctx, ret ? ret : -EAGAIN);
+			return;
+		} else if (ret == 0) {
+			retry = false;
+			LOG_WRN("Send returned 0, retrying once");
+		} else {
+			LOG_DBG("Sent %d bytes", ret);
+			retry = true;
+			buf += ret;
+			len -= ret;
+		}
+	}
+}
+
+/* Lock mutex_data, before calling. */
+static void raw_write(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
+{
+	if (IS_ENABLED(CONFIG_SM_DATAMODE_ZERO_COPY) && ctx->data_mode.zero_copy) {
+		raw_send_direct(ctx, buf, len);
+	} else {
+		write_data_buf(buf, len);
+	}
+}
+
 static void raw_send_scheduled(struct k_work *work)
 {
 	struct sm_at_host_ctx *ctx =
@@ -796,7 +1019,7 @@ static void raw_send_scheduled(struct k_work *work)
 
 	/* Interpret partial quit_str as data, if we send due to timeout. */
 	if (ctx->quit_str_match > 0) {
-		write_data_buf(CONFIG_SM_DATAMODE_TERMINATOR, ctx->quit_str_match);
+		raw_write(ctx, CONFIG_SM_DATAMODE_TERMINATOR, ctx->quit_str_match);
 		ctx->quit_str_match = 0;
 	}
 
@@ -813,52 +1036,102 @@ static void inactivity_timer_handler(struct k_timer *timer)
 	struct sm_at_host_ctx *ctx =
 		CONTAINER_OF(timer, struct sm_at_host_ctx, data_inactivity_timer);
 
+	uint32_t idle_ms = k_uptime_get_32() - (uint32_t)atomic_get(&ctx->data_last_rx);
+
+	if (ctx->at_mode != SM_DATA_MODE) {
+		/* Data mode was exited while the timer was running. */
+		return;
+	}
+
+	if (idle_ms < ctx->data_mode.time_limit) {
+		/* Data was received after the timer was started. */
+		k_timer_start(timer, K_MSEC(ctx->data_mode.time_limit - idle_ms), K_NO_WAIT);
+		return;
+	}
+
 	LOG_DBG("Time limit reached");
-	if (!ring_buf_is_empty(&ctx->data_rb)) {
+	if (!ring_buf_is_empty(&ctx->data_rb) ||
+	    (ctx->data_mode.zero_copy && ctx->quit_str_match > 0)) {
 		k_work_submit_to_queue(&sm_work_q, &ctx->raw_send_scheduled_work);
 	} else {
 		LOG_DBG("data buffer empty");
 	}
 }
 
-/* Search for quit_str and send data prior to that. Tracks quit_str over several calls. */
-static size_t raw_rx_handler(struct sm_at_host_ctx *ctx, uint8_t c)
+/* Lock mutex_data, before calling. */
+static void raw_rx_quit_str_found(struct sm_at_host_ctx *ctx)
 {
-	k_mutex_lock(&ctx->mutex_data, K_FOREVER);
+	raw_send(SM_DATAMODE_FLAGS_NONE);
+	(void)exit_datamode(ctx);
+	ctx->quit_str_match = 0;
+}
 
+/* Search for quit_str and send data prior to that. Tracks quit_str over several calls.
+ * Data between quit_str candidates is written to the data buffer a span at a time.
+ * Returns the number of bytes consumed, which is less than len if data mode was exited.
+ */
+static size_t raw_rx_handler(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
+{
 	const char *const quit_str = CONFIG_SM_DATAMODE_TERMINATOR;
+	const size_t quit_str_len = strlen(quit_str);
+	const uint8_t *match;
+	size_t span;
+	size_t i = 0;
 
-	/* If <data_len> is set in datamode, skip searching for quit_str. Just send data until
-	 * length is reached.
-	 */
-	if (ctx->data_mode.data_len > 0) {
-		write_data_buf(&c, 1);
-		ctx->data_mode.data_len--;
-		if (ctx->data_mode.data_len == 0) {
-			raw_send(SM_DATAMODE_FLAGS_NONE);
-			(void)exit_datamode(ctx);
-		}
-	} else {
-retry_match:	/* Find quit_str or partial match at the end of the buffer. */
-		if (c == quit_str[ctx->quit_str_match]) {
-			ctx->quit_str_match++;
-			if (ctx->quit_str_match == strlen(quit_str)) {
+	k_mutex_lock(&ctx->mutex_data, K_FOREVER);
+
+	while (i < len && get_sm_mode(ctx) == SM_DATA_MODE) {
+		/* If <data_len> is set in datamode, skip searching for quit_str. Just send data
+		 * until length is reached.
+		 */
+		if (ctx->data_mode.data_len > 0) {
+			span = MIN(len - i, ctx->data_mode.data_len);
+			raw_write(ctx, buf + i, span);
+			ctx->data_mode.data_len -= span;
+			i += span;
+			if (ctx->data_mode.data_len == 0) {
 				raw_send(SM_DATAMODE_FLAGS_NONE);
 				(void)exit_datamode(ctx);
+			}
+			continue;
+		}
+
+		/* Continue a partial match, which may span several calls. */
+		if (ctx->quit_str_match > 0) {
+			if (buf[i] == quit_str[ctx->quit_str_match]) {
+				ctx->quit_str_match++;
+				i++;
+				if (ctx->quit_str_match == quit_str_len) {
+					raw_rx_quit_str_found(ctx);
+				}
+			} else {
+				/* Write data which was previously interpreted as a possible
+				 * quit_str and retry the current character as a new match.
+				 */
+				raw_write(ctx, quit_str, ctx->quit_str_match);
 				ctx->quit_str_match = 0;
 			}
-		} else if (ctx->quit_str_match > 0) {
-			/* Write data which was previously interpreted as a possible quit_str. */
-			write_data_buf(quit_str, ctx->quit_str_match);
-			ctx->quit_str_match = 0;
-			goto retry_match;
-		} else {
-			write_data_buf(&c, 1);
+			continue;
+		}
+
+		/* Write everything up to the next possible start of quit_str in one go. */
+		match = memchr(buf + i, quit_str[0], len - i);
+		span = match ? (size_t)(match - (buf + i)) : len - i;
+		if (span > 0) {
+			raw_write(ctx, buf + i, span);
+			i += span;
+		}
+		if (match) {
+			ctx->quit_str_match = 1;
+			i++;
+			if (quit_str_len == 1) {
+				raw_rx_quit_str_found(ctx);
+			}
 		}
 	}
 	k_mutex_unlock(&ctx->mutex_data);
 
-	return 1;
+	return i;
 }
 
 /*
@@ -1053,16 +1326,19 @@ static int sm_at_send_internal(struct sm_at_host_ctx *ctx, const uint8_t *data,
 			}
 		} else {
 			LOG_DBG("URC to pipe=%p: %s", ctx->pipe, (const char *)data);
-			/* Pipe specific URC */
-			struct urc_msg *msg = calloc(1, sizeof(struct urc_msg) + len + 1);
-
-			if (!msg) {
-				LOG_ERR("Failed to allocate URC message");
-				return -ENOMEM;
+			/* Pipe specific URC, buffered whole or not at all */
+			ret = -ENOBUFS;
+			k_mutex_lock(&ctx->mutex_urc, K_FOREVER);
+			if (ring_buf_space_get(&ctx->urc_rb) >= len) {
+				ring_buf_put(&ctx->urc_rb, data, len);
+				ret = 0;
+			} else {
+				ctx->urc_dropped++;
 			}
-			strcpy(msg->urc, (const char *)data);
-			K_SPINLOCK(&sm_at_host_lock) {
-				sys_slist_append(&ctx->buffered_urcs, &msg->node);
+			k_mutex_unlock(&ctx->mutex_urc);
+			if (ret) {
+				LOG_ERR("Pipe URC buffer full, dropped %zu bytes", len);
+				return ret;
 			}
 		}
 		if (ctx) {
@@ -1130,11 +1406,44 @@ static void handle_bootloader_at_cmd(uint8_t *buf, size_t buf_size, char *at_cmd
 	}
 }
 
+#if defined(CONFIG_SM_AT_CMD_INDEX)
+static struct sm_at_cmd_index at_cmd_index;
+
+static void at_cmd_index_init(void)
+{
+	extern struct nrf_modem_at_cmd_custom _nrf_modem_at_cmd_custom_list_start[];
+	extern struct nrf_modem_at_cmd_custom _nrf_modem_at_cmd_custom_list_end[];
+	size_t count = _nrf_modem_at_cmd_custom_list_end - _nrf_modem_at_cmd_custom_list_start;
+	int err;
+
+	err = sm_at_cmd_index_build(&at_cmd_index, _nrf_modem_at_cmd_custom_list_start, count);
+	if (err) {
+		LOG_WRN("Custom AT commands not indexed (%d), count: %zu", err, count);
+	}
+}
+#endif
+
+/* Resolves custom AT commands from the index before passing the command to the modem library.
+ * The modem library still walks its filters for the commands that are not in the index.
+ */
+static int at_cmd_dispatch(char *buf, size_t len, char *at_cmd)
+{
+#if defined(CONFIG_SM_AT_CMD_INDEX)
+	const struct nrf_modem_at_cmd_custom *entry = sm_at_cmd_index_find(&at_cmd_index, at_cmd);
+
+	if (entry) {
+		return entry->callback(buf, len, at_cmd);
+	}
+#endif
+	return nrf_modem_at_cmd(buf, len, "%s", at_cmd);
+}
+
 static void cmd_send(struct sm_at_host_ctx *ctx, uint8_t *buf, size_t cmd_length)
 {
 	int err;
 	size_t offset = 0;
 	char *at_cmd = buf;
+	uint8_t *rsp_buf = ctx->rsp->cmd;
 
 	LOG_HEXDUMP_DBG(buf, cmd_length, "RX");
 
@@ -1163,7 +1472,7 @@ static void cmd_send(struct sm_at_host_ctx *ctx, uint8_t *buf, size_t cmd_length
 
 	/* If bootloader mode is enabled, handle custom AT commands. */
 	if (sm_bootloader_mode_enabled) {
-		handle_bootloader_at_cmd(sm_response_buf, sizeof(sm_response_buf), at_cmd);
+		handle_bootloader_at_cmd(rsp_buf, sizeof(ctx->rsp->cmd), at_cmd);
 		return;
 	}
 
@@ -1173,8 +1482,8 @@ static void cmd_send(struct sm_at_host_ctx *ctx, uint8_t *buf, size_t cmd_length
 	/* Send to modem.
 	 * Reserve space for CRLF in the response buffer.
 	 */
-	err = nrf_modem_at_cmd(sm_response_buf + strlen(CRLF_STR),
-			       sizeof(sm_response_buf) - strlen(CRLF_STR), "%s", at_cmd);
+	err = at_cmd_dispatch(rsp_buf + strlen(CRLF_STR),
+			      sizeof(ctx->rsp->cmd) - strlen(CRLF_STR), at_cmd);
 
 	if (err == -AT_COMMAND_CONTINUE_RET) {
 		return;
@@ -1194,12 +1503,11 @@ static void cmd_send(struct sm_at_host_ctx *ctx, uint8_t *buf, size_t cmd_length
 	/** Format as TS 27.007 command V1 with verbose response format,
 	 *  based on current return of API nrf_modem_at_cmd() and MFWv1.3.x
 	 */
-	sm_response_buf[0] = CR;
-	sm_response_buf[1] = LF;
-	if (strlen(sm_response_buf) > strlen(CRLF_STR)) {
-		format_final_result(sm_response_buf, strlen(sm_response_buf),
-				    sizeof(sm_response_buf));
-		err = sm_at_send_internal(ctx, sm_response_buf, strlen(sm_response_buf), false,
+	rsp_buf[0] = CR;
+	rsp_buf[1] = LF;
+	if (strlen(rsp_buf) > strlen(CRLF_STR)) {
+		format_final_result(rsp_buf, strlen(rsp_buf), sizeof(ctx->rsp->cmd));
+		err = sm_at_send_internal(ctx, rsp_buf, strlen(rsp_buf), false,
 					  SM_DEBUG_PRINT_FULL);
 		if (err) {
 			LOG_ERR("AT command response failed: %d", err);
@@ -1235,11 +1543,94 @@ void sm_at_host_lock_ctx(struct sm_at_host_ctx *ctx)
 	atomic_inc(&ctx->executing_lock);
 }
 
-static size_t cmd_rx_handler(struct sm_at_host_ctx *ctx, uint8_t c)
+/* Contiguous run of received characters to echo in one transmission. */
+struct echo_span {
+	const uint8_t *data;
+	size_t len;
+};
+
+static void echo_flush(struct sm_at_host_ctx *ctx, struct echo_span *echo)
 {
-	bool send = false;
+	if (echo->len) {
+		(void)sm_at_send_internal(ctx, echo->data, echo->len, false, SM_DEBUG_PRINT_NONE);
+		echo->len = 0;
+	}
+}
 
-	check_idle_timer(ctx, true);
+static void echo_append(struct sm_at_host_ctx *ctx, struct echo_span *echo, const uint8_t *c)
+{
+	if (echo->len && echo->data + echo->len == c) {
+		echo->len++;
+		return;
+	}
+
+	echo_flush(ctx, echo);
+	echo->data = c;
+	echo->len = 1;
+}
+
+/* Resize the AT command buffer. Returns false if the buffer could not be resized. */
+static bool at_buf_resize(struct sm_at_host_ctx *ctx, size_t new_size)
+{
+	uint8_t *new_buf = realloc(ctx->at_buf, new_size);
+
+	if (!new_buf) {
+		return false;
+	}
+
+	if (new_size > ctx->at_buf_size) {
+		size_t in_use = atomic_add(&at_buf_stats.bytes, new_size - ctx->at_buf_size) +
+				new_size - ctx->at_buf_size;
+
+		atomic_inc(&at_buf_stats.grows);
+		if (in_use > atomic_get(&at_buf_stats.peak)) {
+			atomic_set(&at_buf_stats.peak, in_use);
+		}
+	} else {
+		atomic_sub(&at_buf_stats.bytes, ctx->at_buf_size - new_size);
+		atomic_inc(&at_buf_stats.shrinks);
+	}
+	ctx->at_buf = new_buf;
+	ctx->at_buf_size = new_size;
+
+	LOG_DBG("AT command buffer resized to %zu (grows %ld, shrinks %ld, in use %ld, peak %ld)",
+		new_size, atomic_get(&at_buf_stats.grows), atomic_get(&at_buf_stats.shrinks),
+		atomic_get(&at_buf_stats.bytes), atomic_get(&at_buf_stats.peak));
+
+	return true;
+}
+
+/* Release a grown AT command buffer once it has not been needed for
+ * CONFIG_SM_AT_BUF_SHRINK_DELAY consecutive commands. Called when a command line is done.
+ */
+static void at_buf_release(struct sm_at_host_ctx *ctx)
+{
+	if (ctx->at_buf_size == AT_BUF_MIN_SIZE) {
+		return;
+	}
+
+	if (ctx->at_cmd_len >= AT_BUF_MIN_SIZE - 2) {
+		/* The grown buffer was needed. */
+		ctx->at_buf_short_cmds = 0;
+		if (CONFIG_SM_AT_BUF_SHRINK_DELAY > 0) {
+			return;
+		}
+	} else if (++ctx->at_buf_short_cmds < CONFIG_SM_AT_BUF_SHRINK_DELAY) {
+		return;
+	}
+
+	if (at_buf_resize(ctx, AT_BUF_MIN_SIZE)) {
+		ctx->at_buf_short_cmds = 0;
+	}
+}
+
+/* Handle a single character in AT command mode. Characters to echo are collected in echo,
+ * which is flushed before anything else is sent. Returns true if a command line was completed.
+ */
+static bool cmd_rx_char(struct sm_at_host_ctx *ctx, const uint8_t *pc, struct echo_span *echo)
+{
+	const uint8_t c = *pc;
+	bool send = false;
 
 	/* Don't buffer anything until "AT" is received */
 	if ((ctx->at_cmd_len == 0 && toupper(c) != 'A') ||
@@ -1254,19 +1645,16 @@ static size_t cmd_rx_handler(struct sm_at_host_ctx *ctx, uint8_t c)
 
 		if (new_size > AT_BUF_MAX_SIZE) {
 			LOG_ERR("AT command buffer overflow, max size reached");
+			echo_flush(ctx, echo);
 			rsp_send_error();
 			goto cmd_finnish_or_fail;
 		}
-		uint8_t *new_buf = realloc(ctx->at_buf, new_size);
-
-		if (!new_buf) {
+		if (!at_buf_resize(ctx, new_size)) {
 			LOG_ERR("Failed to expand AT command buffer");
+			echo_flush(ctx, echo);
 			rsp_send_error();
 			goto cmd_finnish_or_fail;
 		}
-		ctx->at_buf = new_buf;
-		ctx->at_buf_size = new_size;
-		LOG_DBG("Expanded AT command buffer to size %zu", new_size);
 	}
 
 	/* Handle control characters */
@@ -1335,12 +1723,12 @@ handle_echo:
 
 		/* Check if echo should be truncated. */
 		if (!truncate) {
-			(void)sm_at_send_internal(ctx, (uint8_t *)&c, 1, false,
-						SM_DEBUG_PRINT_NONE);
+			echo_append(ctx, echo, pc);
 		}
 
 		/* Send truncated termination characters.*/
 		if (send && truncate) {
+			echo_flush(ctx, echo);
 			if (IS_ENABLED(CONFIG_SM_CR_TERMINATION)) {
 				(void)sm_at_send_internal(ctx, (uint8_t *)"\r", 1, false,
 							  SM_DEBUG_PRINT_NONE);
@@ -1355,6 +1743,7 @@ handle_echo:
 	}
 
 	if (send) {
+		echo_flush(ctx, echo);
 		if (ctx->at_cmd_len > ctx->at_buf_size - 1) {
 			LOG_ERR("AT command buffer overflow, %d dropped", ctx->at_cmd_len);
 			rsp_send_error();
@@ -1365,83 +1754,123 @@ handle_echo:
 			/* Ignore 0 size command. */
 		}
 cmd_finnish_or_fail:
+		at_buf_release(ctx);
 		ctx->inside_quotes = false;
 		ctx->at_cmd_len = 0;
 		ctx->echo_len = 0;
-		/* Release extra AT buffer */
-		if (ctx->at_buf_size > AT_BUF_MIN_SIZE) {
-			uint8_t *new_buf = realloc(ctx->at_buf, AT_BUF_MIN_SIZE);
-
-			if (new_buf) {
-				ctx->at_buf = new_buf;
-				ctx->at_buf_size = AT_BUF_MIN_SIZE;
-				LOG_DBG("Released AT command buffer to size %zu", AT_BUF_MIN_SIZE);
-			}
-		}
 		k_timer_stop(&ctx->idle_timer);
 		sm_at_host_event_notify(ctx, SM_EVENT_URC);
 	}
 
-	return 1;
+	return send;
+}
+
+/* Parse AT command characters. Stops after a completed command line, as the command may
+ * change the operating mode. Returns the number of bytes consumed.
+ */
+static size_t cmd_rx_handler(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
+{
+	struct echo_span echo = {0};
+	size_t i = 0;
+
+	check_idle_timer(ctx, true);
+
+	while (i < len) {
+		if (cmd_rx_char(ctx, &buf[i++], &echo)) {
+			break;
+		}
+	}
+	echo_flush(ctx, &echo);
+
+	return i;
 }
 
-/* Search for quit_str and exit datamode when one is found. */
-static size_t null_handler(struct sm_at_host_ctx *ctx, uint8_t c)
+/* Search for quit_str and exit datamode when one is found.
+ * Returns the number of bytes consumed, which is less than len if data mode was exited.
+ */
+static size_t null_handler(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
 {
 	const char *const quit_str = CONFIG_SM_DATAMODE_TERMINATOR;
-	bool match = false;
+	size_t i = 0;
 
 	if (ctx->null_dropped_count == 0) {
 		LOG_WRN("Data pipe broken. Dropping data until data mode is terminated.");
 	}
 
-	if (c == quit_str[ctx->null_match_count]) {
-		ctx->null_match_count++;
-		if (ctx->null_match_count == strlen(quit_str)) {
-			match = true;
+	while (i < len) {
+		const uint8_t c = buf[i++];
+
+		ctx->null_dropped_count++;
+		if (c != quit_str[ctx->null_match_count]) {
+			ctx->null_match_count = 0;
+			continue;
 		}
-	} else {
-		ctx->null_match_count = 0;
-	}
-	ctx->null_dropped_count++;
 
-	if (match) {
-		ctx->null_dropped_count -= strlen(quit_str);
-		ctx->null_dropped_count += ring_buf_size_get(&ctx->data_rb);
-		LOG_WRN("Terminating data mode. Dropped %d bytes", ctx->null_dropped_count);
-		(void)exit_datamode(ctx);
+		ctx->null_match_count++;
+		if (ctx->null_match_count == strlen(quit_str)) {
+			ctx->null_dropped_count -= strlen(quit_str);
+			ctx->null_dropped_count += ring_buf_size_get(&ctx->data_rb);
+			LOG_WRN("Terminating data mode. Dropped %d bytes",
+				ctx->null_dropped_count);
+			(void)exit_datamode(ctx);
 
-		ctx->null_match_count = 0;
-		ctx->null_dropped_count = 0;
+			ctx->null_match_count = 0;
+			ctx->null_dropped_count = 0;
+			break;
+		}
 	}
 
-	return 1;
+	return i;
 }
 
-static size_t sm_at_receive(struct sm_at_host_ctx *ctx, uint8_t c)
+/* Dispatch received data to the handler of the current mode. The mode is re-evaluated
+ * whenever a handler stops early. Returns the number of bytes consumed, which is less
+ * than len only if the pipe of the context was changed while processing, or with
+ * CONFIG_SM_AT_CMD_QUEUE_SIZE if a command is executing.
+ */
+static size_t sm_at_receive(struct sm_at_host_ctx *ctx, const uint8_t *buf, size_t len)
 {
+	struct modem_pipe *pipe = atomic_ptr_get(&ctx->pipe);
 	size_t ret = 0;
+	size_t consumed;
 
-	k_timer_stop(&ctx->data_inactivity_timer);
+	/* Keep a running inactivity timer from expiring while the data is processed. */
+	atomic_set(&ctx->data_last_rx, k_uptime_get_32());
 
-	switch (get_sm_mode(ctx)) {
-	case SM_AT_COMMAND_MODE:
-		ret = cmd_rx_handler(ctx, c);
-		break;
-	case SM_DATA_MODE:
-		ret = raw_rx_handler(ctx, c);
-		break;
-	case SM_NULL_MODE:
-		ret = null_handler(ctx, c);
-		break;
-	default:
-		break;
+	while (ret < len && atomic_ptr_get(&ctx->pipe) == pipe) {
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+		/* Keep the rest in order until the executing command is done. */
+		if (atomic_get(&ctx->executing_lock) > 0) {
+			break;
+		}
+#endif
+		switch (get_sm_mode(ctx)) {
+		case SM_AT_COMMAND_MODE:
+			consumed = cmd_rx_handler(ctx, buf + ret, len - ret);
+			break;
+		case SM_DATA_MODE:
+			consumed = raw_rx_handler(ctx, buf + ret, len - ret);
+			break;
+		case SM_NULL_MODE:
+			consumed = null_handler(ctx, buf + ret, len - ret);
+			break;
+		default:
+			/* Drop data in unknown mode. */
+			consumed = len - ret;
+			break;
+		}
+		ret += consumed;
 	}
 
-	/* start inactivity timer in datamode */
+	/* Start inactivity timer in datamode. A running timer re-arms itself from the time of
+	 * the last activity when it expires, so it is not restarted for every chunk.
+	 */
 	if (get_sm_mode(ctx) == SM_DATA_MODE) {
-		k_timer_start(&ctx->data_inactivity_timer, K_MSEC(ctx->data_mode.time_limit),
-			      K_NO_WAIT);
+		atomic_set(&ctx->data_last_rx, k_uptime_get_32());
+		if (k_timer_remaining_ticks(&ctx->data_inactivity_timer) == 0) {
+			k_timer_start(&ctx->data_inactivity_timer,
+				      K_MSEC(ctx->data_mode.time_limit), K_NO_WAIT);
+		}
 	}
 
 	return ret;
@@ -1451,7 +1880,7 @@ AT_MONITOR(at_notify, ANY, notification_handler);
 
 static void notification_handler(const char *notification)
 {
-#if defined(CONFIG_SM_PPP)
+#if defined(CONFIG_SM_CGEV)
 	if (!sm_fwd_cgev_notifs && !strncmp(notification, "+CGEV: ", strlen("+CGEV: "))) {
 		/* CGEV notifications are silenced. Do not forward them. */
 		return;
@@ -1474,18 +1903,26 @@ void rsp_send_error(void)
 static void rsp_send_internal(struct sm_at_host_ctx *ctx, bool urc, const char *fmt,
 			      va_list arg_ptr)
 {
-	static K_MUTEX_DEFINE(mutex_rsp_buf);
-	static char rsp_buf[SM_AT_MAX_RSP_LEN];
+	/* Used for URCs that are not targeted to any context. */
+	static K_MUTEX_DEFINE(mutex_urc_buf);
+	static char urc_fmt_buf[SM_AT_MAX_RSP_LEN];
+	struct k_mutex *mutex = &mutex_urc_buf;
+	char *rsp_buf = urc_fmt_buf;
 	int rsp_len;
 
-	k_mutex_lock(&mutex_rsp_buf, K_FOREVER);
+	if (ctx) {
+		mutex = &ctx->mutex_rsp;
+		rsp_buf = ctx->rsp->fmt;
+	}
+
+	k_mutex_lock(mutex, K_FOREVER);
 
-	rsp_len = vsnprintf(rsp_buf, sizeof(rsp_buf), fmt, arg_ptr);
-	rsp_len = MIN(rsp_len, sizeof(rsp_buf) - 1);
+	rsp_len = vsnprintf(rsp_buf, SM_AT_MAX_RSP_LEN, fmt, arg_ptr);
+	rsp_len = MIN(rsp_len, SM_AT_MAX_RSP_LEN - 1);
 
 	sm_at_send_internal(ctx, rsp_buf, rsp_len, urc, SM_DEBUG_PRINT_FULL);
 
-	k_mutex_unlock(&mutex_rsp_buf);
+	k_mutex_unlock(mutex);
 }
 
 void urc_send_to(struct modem_pipe *pipe, const char *fmt, ...)
@@ -1560,6 +1997,100 @@ void data_send(struct modem_pipe *pipe, const uint8_t *data, size_t len)
 	sm_at_send_internal(ctx, data, len, false, SM_DEBUG_PRINT_SHORT);
 }
 
+/* Transmit data segments back to back. Segments are gathered to a single transmission when
+ * they fit in the response formatting buffer of the context.
+ */
+static int sm_at_host_pipe_txv_blocking(struct sm_at_host_ctx *ctx, const struct sm_iovec *iov,
+					size_t iovcnt)
+{
+	size_t total = 0;
+	size_t offset = 0;
+	int ret = 0;
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		total += iov[i].len;
+	}
+
+	if (total <= sizeof(ctx->rsp->fmt)) {
+		k_mutex_lock(&ctx->mutex_rsp, K_FOREVER);
+		for (size_t i = 0; i < iovcnt; i++) {
+			memcpy(ctx->rsp->fmt + offset, iov[i].base, iov[i].len);
+			offset += iov[i].len;
+		}
+		ret = sm_at_host_pipe_tx_blocking(ctx, ctx->rsp->fmt, total);
+		k_mutex_unlock(&ctx->mutex_rsp);
+		return ret;
+	}
+
+	for (size_t i = 0; i < iovcnt && ret >= 0; i++) {
+		if (iov[i].len > 0) {
+			ret = sm_at_host_pipe_tx_blocking(ctx, iov[i].base, iov[i].len);
+		}
+	}
+
+	return ret < 0 ? ret : total;
+}
+
+void data_sendv(struct modem_pipe *pipe, const struct sm_iovec *iov, size_t iovcnt)
+{
+	struct sm_at_host_ctx *ctx = sm_at_host_get_ctx_from(pipe);
+	int ret;
+
+	if (!sm_at_ctx_check(ctx)) {
+		return;
+	}
+	if (k_is_in_isr()) {
+		LOG_ERR("FIXME: Attempt to send data in ISR.");
+		return;
+	}
+	if (is_idle(ctx)) {
+		flush_pipe_urcs(ctx);
+	}
+
+	ret = sm_at_host_pipe_txv_blocking(ctx, iov, iovcnt);
+	if (ret < 0) {
+		LOG_ERR("Data send failed: %d", ret);
+		return;
+	}
+
+	for (size_t i = 0; i < iovcnt; i++) {
+		LOG_HEXDUMP_DBG(iov[i].base, MIN(HEXDUMP_LIMIT, iov[i].len), "TX");
+	}
+}
+
+void data_send_hex(struct modem_pipe *pipe, const uint8_t *data, size_t len)
+{
+	struct sm_at_host_ctx *ctx = sm_at_host_get_ctx_from(pipe);
+	/* Bytes encoded per transmission, leaving room for the null terminator. */
+	const size_t block = (sizeof(ctx->rsp->fmt) - 1) / 2;
+	int ret = 0;
+
+	if (!sm_at_ctx_check(ctx)) {
+		return;
+	}
+	if (k_is_in_isr()) {
+		LOG_ERR("FIXME: Attempt to send data in ISR.");
+		return;
+	}
+	if (is_idle(ctx)) {
+		flush_pipe_urcs(ctx);
+	}
+
+	k_mutex_lock(&ctx->mutex_rsp, K_FOREVER);
+	for (size_t done = 0; done < len && ret >= 0;) {
+		size_t n = MIN(block, len - done);
+		size_t size = util_bin2hex(data + done, n, ctx->rsp->fmt, sizeof(ctx->rsp->fmt));
+
+		ret = sm_at_host_pipe_tx_blocking(ctx, ctx->rsp->fmt, size);
+		done += n;
+	}
+	k_mutex_unlock(&ctx->mutex_rsp);
+
+	if (ret < 0) {
+		LOG_ERR("Data send failed: %d", ret);
+	}
+}
+
 static uint16_t get_min_data_mode_idle_timeout_ms(void)
 {
 	uint16_t min_time_limit;
@@ -1582,12 +2113,18 @@ static uint16_t get_min_data_mode_idle_timeout_ms(void)
 	return min_time_limit;
 }
 
-int enter_datamode(sm_datamode_handler_t handler, size_t data_len)
+static int enter_datamode_internal(sm_datamode_handler_t handler, size_t data_len, bool stream)
 {
 	struct sm_at_host_ctx *ctx = sm_at_host_get_current();
 
-	if (handler == NULL || ctx->data_mode.handler != NULL ||
-	    set_sm_mode(ctx, SM_DATA_MODE) == false) {
+	if (handler == NULL || ctx->data_mode.handler != NULL) {
+		LOG_ERR("Failed to enter data mode");
+		return -EINVAL;
+	}
+
+	ctx->data_mode.zero_copy = IS_ENABLED(CONFIG_SM_DATAMODE_ZERO_COPY) && stream;
+	if (set_sm_mode(ctx, SM_DATA_MODE) == false) {
+		ctx->data_mode.zero_copy = false;
 		LOG_ERR("Failed to enter data mode");
 		return -EINVAL;
 	}
@@ -1601,11 +2138,21 @@ int enter_datamode(sm_datamode_handler_t handler, size_t data_len)
 	if (ctx->data_mode.time_limit == 0) {
 		ctx->data_mode.time_limit = get_min_data_mode_idle_timeout_ms();
 	}
-	LOG_INF("Enter data mode");
+	LOG_INF("Enter data mode%s", ctx->data_mode.zero_copy ? " (zero-copy)" : "");
 
 	return 0;
 }
 
+int enter_datamode(sm_datamode_handler_t handler, size_t data_len)
+{
+	return enter_datamode_internal(handler, data_len, false);
+}
+
+int enter_datamode_stream(sm_datamode_handler_t handler, size_t data_len)
+{
+	return enter_datamode_internal(handler, data_len, true);
+}
+
 bool in_datamode_ctx(struct sm_at_host_ctx *ctx)
 {
 	return (get_sm_mode(ctx) == SM_DATA_MODE);
@@ -1665,6 +2212,7 @@ void exit_datamode_handler(struct sm_at_host_ctx *ctx, int result)
 		ctx->data_mode.handler = NULL;
 		ctx->data_mode.handler_result = result;
 		ctx->data_mode.data_len = 0;
+		ctx->data_mode.zero_copy = false;
 		sm_at_host_set_current_ctx(NULL);
 	}
 }
@@ -1789,29 +2337,51 @@ void sm_at_host_echo(bool enable)
 static void idle_timer_handler(struct k_timer *timer)
 {
 	struct sm_at_host_ctx *ctx = CONTAINER_OF(timer, struct sm_at_host_ctx, idle_timer);
+	int32_t remaining_ms = (int32_t)((uint32_t)atomic_get(&ctx->idle_deadline) -
+					 k_uptime_get_32());
+
+	if (remaining_ms > 0) {
+		/* Input was received after the timer was started. */
+		k_timer_start(timer, K_MSEC(remaining_ms), K_NO_WAIT);
+		return;
+	}
 
 	sm_at_host_event_notify(ctx, SM_EVENT_URC);
 }
 
 static void flush_pipe_urcs(struct sm_at_host_ctx *ctx)
 {
-	sys_snode_t *node;
+	uint8_t *p;
+	uint32_t len;
+	uint32_t dropped;
 
 	/* Flush global URCs, in case this is the target pipe */
 	send_urcs(ctx);
 
-	/* Flush channel specific URCs send by urc_send_to() */
+	k_mutex_lock(&ctx->mutex_urc, K_FOREVER);
+	dropped = ctx->urc_dropped;
+	ctx->urc_dropped = 0;
+	k_mutex_unlock(&ctx->mutex_urc);
+	if (dropped) {
+		LOG_WRN("Dropped %u URCs for pipe %p", dropped, (void *)atomic_ptr_get(&ctx->pipe));
+	}
+
+	/* Flush channel specific URCs sent by urc_send_to(), as many as are contiguous at once */
 	do {
-		K_SPINLOCK(&sm_at_host_lock) {
-			node = sys_slist_get(&ctx->buffered_urcs);
-		}
-		if (!node) {
+		k_mutex_lock(&ctx->mutex_urc, K_FOREVER);
+		len = ring_buf_get_claim(&ctx->urc_rb, &p, sizeof(ctx->urc_rb_buf));
+		k_mutex_unlock(&ctx->mutex_urc);
+		if (len == 0) {
 			break;
 		}
-		struct urc_msg *msg = CONTAINER_OF(node, struct urc_msg, node);
+		int send = sm_at_host_pipe_tx_blocking(ctx, p, len);
 
-		sm_at_host_pipe_tx_blocking(ctx, (uint8_t *)msg->urc, strlen(msg->urc));
-		free(msg);
+		if (send < (int)len) {
+			LOG_ERR("Failed to send URC: %d (ctx %p)", send, ctx);
+		}
+		k_mutex_lock(&ctx->mutex_urc, K_FOREVER);
+		ring_buf_get_finish(&ctx->urc_rb, len);
+		k_mutex_unlock(&ctx->mutex_urc);
 	} while (true);
 }
 
@@ -1862,8 +2432,17 @@ static int sm_at_host_ctx_init(struct sm_at_host_ctx *ctx, struct modem_pipe *pi
 	}
 	ctx->at_buf_size = AT_BUF_MIN_SIZE;
 
+	if (k_mem_slab_alloc(&rsp_buf_slab, (void **)&ctx->rsp, K_NO_WAIT)) {
+		LOG_ERR("Failed to allocate AT response buffer");
+		free(ctx->at_buf);
+		return -ENOMEM;
+	}
+	atomic_add(&at_buf_stats.bytes, AT_BUF_MIN_SIZE);
+
 	/* Initialize mutexes */
 	k_mutex_init(&ctx->mutex_data);
+	k_mutex_init(&ctx->mutex_rsp);
+	k_mutex_init(&ctx->mutex_urc);
 	k_event_init(&ctx->pipe_event);
 
 	/* Initialize mode */
@@ -1878,7 +2457,10 @@ static int sm_at_host_ctx_init(struct sm_at_host_ctx *ctx, struct modem_pipe *pi
 	k_timer_init(&ctx->data_inactivity_timer, inactivity_timer_handler, NULL);
 	k_timer_init(&ctx->idle_timer, idle_timer_handler, NULL);
 	sys_slist_init(&ctx->idle_work_list);
-	sys_slist_init(&ctx->buffered_urcs);
+	ring_buf_init(&ctx->urc_rb, sizeof(ctx->urc_rb_buf), ctx->urc_rb_buf);
+#if CONFIG_SM_AT_CMD_QUEUE_SIZE > 0
+	ring_buf_init(&ctx->cmd_queue, sizeof(ctx->cmd_queue_buf), ctx->cmd_queue_buf);
+#endif
 
 	return 0;
 }
@@ -2086,24 +2668,18 @@ static int sm_at_host_destroy(struct sm_at_host_ctx *ctx)
 	k_work_cancel_sync(&ctx->rx_work, &sync);
 	k_work_cancel_sync(&ctx->raw_send_scheduled_work, &sync);
 
-	/* Remove from instance list and free buffered URCs */
+	/* Remove from instance list, buffered URCs are freed with the context */
 	K_SPINLOCK(&sm_at_host_lock) {
-		sys_snode_t *node;
-		sys_snode_t *next;
-		struct urc_msg *msg;
-
 		sys_slist_find_and_remove(&instance_list, &ctx->node);
-		SYS_SLIST_FOR_EACH_NODE_SAFE(&ctx->buffered_urcs, node, next) {
-			msg = CONTAINER_OF(node, struct urc_msg, node);
-			free(msg);
-		}
 	}
 
 	LOG_INF("Destroyed AT host instance %p", (void *)ctx);
 
 	/* Free the context */
 	free(ctx->data_rb_buf);
+	atomic_sub(&at_buf_stats.bytes, ctx->at_buf_size);
 	free(ctx->at_buf);
+	k_mem_slab_free(&rsp_buf_slab, ctx->rsp);
 	free(ctx);
 
 	return 0;
@@ -2115,6 +2691,10 @@ static int sm_at_host_init(void)
 	struct sm_at_host_ctx *ctx;
 	int err;
 
+#if defined(CONFIG_SM_AT_CMD_INDEX)
+	at_cmd_index_init();
+#endif
+
 	if (!pipe) {
 		LOG_ERR("No UART pipe available for AT host");
 		return -ENODEV;
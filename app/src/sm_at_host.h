@@ -138,6 +138,41 @@ void rsp_send_error(void);
  */
 void data_send(struct modem_pipe *pipe, const uint8_t *data, size_t len);
 
+/** Data segment for data_sendv(). */
+struct sm_iovec {
+	const void *base;
+	size_t len;
+};
+
+/**
+ * @brief Send raw data segments received in data mode or AT mode as one transmission
+ *
+ * Same as @ref data_send, but the data is given in segments, for example a response header,
+ * a payload and a trailing CRLF. The segments are transmitted back to back, and gathered to a
+ * single pipe transmission when they fit in the response buffer of the pipe.
+ * Segments with zero length are skipped.
+ *
+ * @param pipe Modem pipe to send data through
+ * @param iov Data segments
+ * @param iovcnt Number of data segments
+ *
+ */
+void data_sendv(struct modem_pipe *pipe, const struct sm_iovec *iov, size_t iovcnt);
+
+/**
+ * @brief Send raw data as a hex string
+ *
+ * Same as @ref data_send, but the data is sent as a lowercase hex string. The data is encoded
+ * directly to the response buffer of the pipe, and the whole string is sent without other
+ * transmissions in between.
+ *
+ * @param pipe Modem pipe to send data through
+ * @param data Raw data
+ * @param len Length of raw data
+ *
+ */
+void data_send_hex(struct modem_pipe *pipe, const uint8_t *data, size_t len);
+
 /**
  * @brief Request Serial Modem AT host to enter data mode
  *
@@ -152,6 +187,22 @@ void data_send(struct modem_pipe *pipe, const uint8_t *data, size_t len);
  */
 int enter_datamode(sm_datamode_handler_t handler, size_t data_len);
 
+/**
+ * @brief Request Serial Modem AT host to enter data mode for stream data
+ *
+ * Same as @ref enter_datamode, but the handler must accept the data in pieces of any size.
+ * With CONFIG_SM_DATAMODE_ZERO_COPY, the data is passed to the handler as soon as it is
+ * received, without copying it to the data mode buffer.
+ *
+ * @param handler Data mode handler provided by requesting module
+ * @param data_len Expected data length to be sent in data mode. 0 means unknown length and
+ *        that the termination command is required to exit the data mode.
+ *
+ * @retval 0 If the operation was successful.
+ *         Otherwise, a (negative) error code is returned.
+ */
+int enter_datamode_stream(sm_datamode_handler_t handler, size_t data_len);
+
 bool in_datamode_ctx(struct sm_at_host_ctx *ctx);
 bool in_datamode_pipe(struct modem_pipe *pipe);
 bool in_at_mode_ctx(struct sm_at_host_ctx *ctx);
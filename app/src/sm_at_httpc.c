@@ -14,9 +14,12 @@
 #include <modem/at_parser.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include "sm_util.h"
 #include "sm_at_host.h"
 #include "sm_at_httpc.h"
+#include "sm_http_chunked.h"
+#include "sm_http_header.h"
 
 LOG_MODULE_REGISTER(sm_httpc, CONFIG_SM_LOG_LEVEL);
 
@@ -27,6 +30,10 @@ LOG_MODULE_REGISTER(sm_httpc, CONFIG_SM_LOG_LEVEL);
 #define HTTP_EXTRA_HEADERS_SIZE   512
 #define HTTP_RESPONSE_TIMEOUT_MS  CONFIG_SM_HTTPC_RESPONSE_TIMEOUT_MS
 #define HTTP_MAX_REQUESTS         NRF_MODEM_MAX_SOCKET_COUNT
+#define HTTP_DL_VALIDATOR_LEN     64
+
+/* Compile-time length of a string literal (excludes null terminator) */
+#define STRLIT_LEN(s) (sizeof(s) - 1)
 
 /* Periodic scan, so idle timeout fires without a socket poll wakeup (silent server). */
 #define HTTP_TIMEOUT_SCAN_MS MIN(1000U, (uint32_t)HTTP_RESPONSE_TIMEOUT_MS / 4U)
@@ -38,8 +45,10 @@ LOG_MODULE_REGISTER(sm_httpc, CONFIG_SM_LOG_LEVEL);
 
 /* Forward declarations of socket functions */
 extern struct sm_socket *find_socket(int fd);
+extern int find_socket_slot(int fd);
 extern int set_xapoll_events(struct sm_socket *sock, uint8_t events);
 extern void xapoll_stop(struct sm_socket *sock);
+extern int get_socket_sec_tag(struct sm_socket *sock);
 
 /* HTTP request methods */
 enum sm_http_method {
@@ -59,6 +68,18 @@ enum http_state {
 	HTTP_STATE_RECEIVING_BODY,
 };
 
+#if defined(CONFIG_SM_HTTPC_DL)
+/* Resumable download of a resource, kept when the download is interrupted. */
+struct http_dl {
+	char url[HTTP_URL_MAX_LEN];            /* URL of the resource, empty if the entry is free */
+	char validator[HTTP_DL_VALIDATOR_LEN]; /* ETag or Last-Modified, empty if none */
+	int offset;                            /* Bytes of the resource delivered to the host */
+	int total;                             /* Length of the resource, -1 if unknown */
+	int64_t used;                          /* Uptime of the last use, for replacement */
+	bool active;                           /* A request is downloading the resource */
+};
+#endif
+
 /* HTTP request structure */
 struct http_request {
 	int fd;                     /* Socket file descriptor (from AT socket) */
@@ -85,6 +106,23 @@ struct http_request {
 	bool hex_rx;                /* Deliver response body as ASCII hex string */
 	int bytes_sent;             /* Response-body bytes sent to the host */
 	bool connection_close;      /* Server sent "Connection: close" header */
+	bool server_closed;         /* Server closed the connection */
+	bool tls;                   /* URL scheme is https */
+	int keep_alive_timeout;     /* Keep-Alive timeout in seconds (-1 if not present) */
+	bool chunked;               /* Response uses chunked transfer coding */
+	struct sm_http_chunked chunked_dec; /* Decoder of the chunked response body */
+	struct sm_http_header header; /* Parser of the response header section */
+	struct http_request *next;  /* Request pipelined after this one on the same socket */
+#if defined(CONFIG_SM_HTTPC_DL)
+	struct http_dl *dl;         /* Resumable download, NULL if not a download */
+	bool dl_started;            /* Response continues or restarts the download */
+	int dl_offset;              /* Offset of the resource at which the body starts */
+	int dl_range_start;         /* First byte position of Content-Range, -1 if not present */
+	int dl_range_total;         /* Complete length of Content-Range, -1 if unknown */
+	int dl_progress;            /* Last reported progress step */
+	char dl_etag[HTTP_DL_VALIDATOR_LEN];          /* Strong ETag of the response */
+	char dl_last_modified[HTTP_DL_VALIDATOR_LEN]; /* Last-Modified of the response */
+#endif
 };
 
 static const char * const http_method_str[] = {
@@ -95,6 +133,9 @@ static const char * const http_method_str[] = {
 	[HTTP_HEAD]   = "HEAD",
 };
 
+/* Requests by the socket slot of their socket, see find_socket_slot(). Pipelined requests
+ * are chained behind the request that is receiving its response.
+ */
 static struct http_request *http_requests[HTTP_MAX_REQUESTS];
 static struct http_request *datamode_req; /* Request waiting for body data */
 
@@ -104,22 +145,401 @@ static void http_close_request(struct http_request *req);
 static void http_fail_request(struct http_request *req);
 static void http_finish_request(struct http_request *req);
 static int http_start_request(struct http_request *req);
-static bool http_headers_complete(struct http_request *req, char *header_end,
+static bool http_headers_complete(struct http_request *req, int body_offset,
 				  struct sm_socket *sock, bool hup);
 static void http_warn_incomplete_transfer(const struct http_request *req);
 static int http_recv_read(struct http_request *req, struct sm_socket *sock);
 static void http_process_recv_headers(struct http_request *req, struct sm_socket *sock,
 				      uint8_t events);
 static void http_process_recv_body(struct http_request *req, struct sm_socket *sock,
-				    uint8_t events);
-static int parse_http_status_code(const char *buf, int *status_code);
-static int parse_content_length(const char *buf, const char *header_end, int *length);
-static bool parse_connection_close(const char *buf, const char *header_end);
+				    uint8_t events, int received);
+static void http_header_field(const char *name, size_t name_len, const char *value,
+			      size_t value_len, void *user_data);
+static int http_parse_url_components(const char *url, size_t url_len, struct http_request *req);
 static void http_timeout_work_fn(struct k_work *work);
+static void http_start_response(struct http_request *req);
 
 static K_MUTEX_DEFINE(http_mutex);
 static K_WORK_DELAYABLE_DEFINE(http_timeout_dwork,  http_timeout_work_fn);
 
+#if defined(CONFIG_SM_HTTPC_POOL)
+/* Handle that selects a pooled connection in AT#XHTTPCREQ. */
+#define HTTP_POOL_HANDLE -1
+
+/* Idle keep-alive connection, kept for the next request to the same server. */
+struct http_pool_conn {
+	int fd;                       /* Socket file descriptor, -1 if the entry is free */
+	bool tls;                     /* Secure socket */
+	uint16_t port;                /* Server port */
+	int64_t expiry;               /* Uptime after which the server may have closed it */
+	char host[HTTP_HOST_MAX_LEN]; /* Server hostname */
+};
+
+/* Pool entries and statistics, protected by http_mutex. */
+static struct http_pool_conn http_pool[CONFIG_SM_HTTPC_POOL_SIZE] = {
+	[0 ... CONFIG_SM_HTTPC_POOL_SIZE - 1] = {.fd = -1},
+};
+static uint32_t http_pool_hits;
+static uint32_t http_pool_misses;
+
+/* Remove a connection from the pool. Returns true if it was pooled. */
+static bool http_pool_remove(int fd)
+{
+	for (int i = 0; i < CONFIG_SM_HTTPC_POOL_SIZE; i++) {
+		if (http_pool[i].fd == fd) {
+			http_pool[i].fd = -1;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Pool the connection of a request that finished with the connection kept open. */
+static void http_pool_put(const struct http_request *req)
+{
+	struct sm_socket *sock = find_socket(req->fd);
+	struct http_pool_conn *conn = NULL;
+	int64_t idle_ms = CONFIG_SM_HTTPC_POOL_IDLE_TIMEOUT * MSEC_PER_SEC;
+
+	if (!sock || !req->hostname) {
+		return;
+	}
+
+	/* Take a free entry, or replace the one that expires first. */
+	http_pool_remove(req->fd);
+	for (int i = 0; i < CONFIG_SM_HTTPC_POOL_SIZE; i++) {
+		if (http_pool[i].fd < 0) {
+			conn = &http_pool[i];
+			break;
+		}
+		if (!conn || http_pool[i].expiry < conn->expiry) {
+			conn = &http_pool[i];
+		}
+	}
+
+	if (req->keep_alive_timeout >= 0) {
+		idle_ms = MIN(idle_ms, (int64_t)req->keep_alive_timeout * MSEC_PER_SEC);
+	}
+
+	conn->fd = req->fd;
+	conn->tls = get_socket_sec_tag(sock) != SEC_TAG_TLS_INVALID;
+	conn->port = req->port;
+	conn->expiry = k_uptime_get() + idle_ms;
+	strncpy(conn->host, req->hostname, sizeof(conn->host) - 1);
+	conn->host[sizeof(conn->host) - 1] = '\0';
+
+	LOG_DBG("HTTP %d: Pooled connection to %s:%d", conn->fd, conn->host, conn->port);
+}
+
+/* Check that an idle connection has neither been closed nor received unexpected data. */
+static bool http_pool_conn_alive(int fd)
+{
+	struct zsock_pollfd fds = {.fd = fd, .events = ZSOCK_POLLIN};
+
+	return zsock_poll(&fds, 1, 0) == 0;
+}
+
+/* Find a live pooled connection to a server. Secure connections are matched regardless of
+ * their security tag. Stale connections are dropped from the pool, their sockets stay open
+ * until the host closes them.
+ */
+static int http_pool_find(const char *host, uint16_t port, bool tls)
+{
+	const int64_t now = k_uptime_get();
+
+	for (int i = 0; i < CONFIG_SM_HTTPC_POOL_SIZE; i++) {
+		struct http_pool_conn *conn = &http_pool[i];
+
+		if (conn->fd < 0 || conn->port != port ||
+		    conn->tls != tls ||
+		    strcasecmp(conn->host, host) != 0) {
+			continue;
+		}
+		if (now > conn->expiry || !http_pool_conn_alive(conn->fd)) {
+			LOG_DBG("HTTP %d: Dropped stale pooled connection", conn->fd);
+			conn->fd = -1;
+			continue;
+		}
+
+		return conn->fd;
+	}
+
+	return -ENOTCONN;
+}
+
+/* Find a pooled connection to the server of a parsed URL. */
+static int http_pool_find_url(const struct http_request *url)
+{
+	int ret;
+
+	k_mutex_lock(&http_mutex, K_FOREVER);
+	ret = http_pool_find(url->hostname, url->port, url->tls);
+	if (ret < 0) {
+		http_pool_misses++;
+	}
+	k_mutex_unlock(&http_mutex);
+
+	return ret;
+}
+
+/* Account a request started on a socket, taking its connection out of the pool. */
+static void http_pool_use(int fd)
+{
+	if (http_pool_remove(fd)) {
+		http_pool_hits++;
+	}
+}
+#endif /* CONFIG_SM_HTTPC_POOL */
+
+#if defined(CONFIG_SM_HTTPC_DL)
+/* Downloads by URL, protected by http_mutex. */
+static struct http_dl http_dls[CONFIG_SM_HTTPC_DL_COUNT];
+
+/* Take the download of a URL for a request. A new entry is taken for an unknown URL,
+ * replacing the least recently used inactive download when all entries are in use.
+ */
+static int http_dl_get(const char *url, size_t url_len, struct http_dl **dl)
+{
+	struct http_dl *entry = NULL;
+
+	for (int i = 0; i < CONFIG_SM_HTTPC_DL_COUNT; i++) {
+		if (strlen(http_dls[i].url) == url_len &&
+		    strncmp(http_dls[i].url, url, url_len) == 0) {
+			if (http_dls[i].active) {
+				return -EBUSY;
+			}
+			entry = &http_dls[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		for (int i = 0; i < CONFIG_SM_HTTPC_DL_COUNT; i++) {
+			if (http_dls[i].active) {
+				continue;
+			}
+			if (!entry || http_dls[i].url[0] == '\0' ||
+			    (entry->url[0] != '\0' && http_dls[i].used < entry->used)) {
+				entry = &http_dls[i];
+			}
+		}
+		if (!entry) {
+			return -ENOMEM;
+		}
+		memcpy(entry->url, url, url_len);
+		entry->url[url_len] = '\0';
+		entry->validator[0] = '\0';
+		entry->offset = 0;
+		entry->total = -1;
+	}
+
+	entry->active = true;
+	entry->used = k_uptime_get();
+	*dl = entry;
+
+	return 0;
+}
+
+/* Release a download. A download with nothing to resume from is forgotten, so that an
+ * entry taken by a request that failed is not kept.
+ */
+static void http_dl_put(struct http_dl *dl)
+{
+	dl->active = false;
+	if (dl->offset == 0 || dl->validator[0] == ' ') {
+		dl->url[0] = ' ';
+	}
+}
+
+/* Release the download of a request. */
+static void http_dl_release(struct http_request *req)
+{
+	if (req->dl) {
+		http_dl_put(req->dl);
+		req->dl = NULL;
+	}
+}
+
+/* Forget the download of a URL. */
+static int http_dl_forget(const char *url, size_t url_len)
+{
+	for (int i = 0; i < CONFIG_SM_HTTPC_DL_COUNT; i++) {
+		if (strlen(http_dls[i].url) == url_len &&
+		    strncmp(http_dls[i].url, url, url_len) == 0) {
+			if (http_dls[i].active) {
+				return -EBUSY;
+			}
+			http_dls[i].url[0] = '\0';
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* Copy a validator field value, if it fits. */
+static void http_dl_copy_validator(char *dst, const char *value, size_t value_len)
+{
+	if (value_len < HTTP_DL_VALIDATOR_LEN) {
+		memcpy(dst, value, value_len);
+		dst[value_len] = '\0';
+	}
+}
+
+/* Keep the response header fields used to resume the download. */
+static void http_dl_field(struct http_request *req, const char *name, size_t name_len,
+			  const char *value, size_t value_len)
+{
+	if (name_len == STRLIT_LEN("ETag") && strncasecmp(name, "ETag", name_len) == 0) {
+		/* Weak entity tags cannot be used in If-Range (RFC 9110 §13.1.5). */
+		if (value_len > 0 && value[0] == '"') {
+			http_dl_copy_validator(req->dl_etag, value, value_len);
+		}
+	} else if (name_len == STRLIT_LEN("Last-Modified") &&
+		   strncasecmp(name, "Last-Modified", name_len) == 0) {
+		http_dl_copy_validator(req->dl_last_modified, value, value_len);
+	} else if (name_len == STRLIT_LEN("Content-Range") &&
+		   strncasecmp(name, "Content-Range", name_len) == 0) {
+		/* "bytes <first>-<last>/<complete-length>", the length can be "*". The receive
+		 * buffer is NUL-terminated, so sscanf() cannot read past it.
+		 */
+		if (sscanf(value, "bytes %d-%*d/%d", &req->dl_range_start,
+			   &req->dl_range_total) < 1) {
+			req->dl_range_start = -1;
+		}
+	}
+}
+
+/* Progress of a download in steps of CONFIG_SM_HTTPC_DL_PROGRESS_STEP percent,
+ * 0 when the progress is not reported.
+ */
+static int http_dl_step(const struct http_dl *dl)
+{
+#if CONFIG_SM_HTTPC_DL_PROGRESS_STEP > 0
+	if (dl->total > 0) {
+		return (int64_t)dl->offset * 100 / dl->total / CONFIG_SM_HTTPC_DL_PROGRESS_STEP;
+	}
+#endif
+	return 0;
+}
+
+/* Keep the offset to resume the download from, and report the progress each time it
+ * crosses a step.
+ */
+static void http_dl_progress(struct http_request *req)
+{
+	struct http_dl *dl = req->dl;
+	int step;
+
+	if (!dl || !req->dl_started) {
+		return;
+	}
+
+	dl->offset = req->dl_offset + req->bytes_sent;
+	step = http_dl_step(dl);
+	if (step > req->dl_progress) {
+		req->dl_progress = step;
+		urc_send_to(req->pipe, "\r\n#XHTTPCPROG: %d,%d,%d\r\n", req->fd, dl->offset,
+			    dl->total);
+	}
+}
+
+/* Check the response headers of a download. A 200 response restarts the download,
+ * a 206 response continues it from the requested offset.
+ */
+static int http_dl_headers(struct http_request *req)
+{
+	struct http_dl *dl = req->dl;
+
+	if (!dl) {
+		return 0;
+	}
+
+	if (req->status_code == 206) {
+		if (req->dl_range_start != req->dl_offset) {
+			LOG_ERR("HTTP %d: Content-Range starts at %d, not at %d", req->fd,
+				req->dl_range_start, req->dl_offset);
+			/* Download from the start on the next attempt. */
+			dl->offset = 0;
+			dl->validator[0] = '\0';
+			return -EBADMSG;
+		}
+		dl->total = req->dl_range_total;
+	} else if (req->status_code == 200) {
+		req->dl_offset = 0;
+		dl->total = req->content_length;
+	} else {
+		if (req->status_code == 416) {
+			/* The offset is past the end of the resource, which may have become
+			 * shorter. Download from the start on the next attempt.
+			 */
+			dl->offset = 0;
+			dl->validator[0] = '\0';
+		}
+		return 0;
+	}
+
+	/* A strong ETag is preferred over the modification date (RFC 9110 §13.1.5). */
+	strcpy(dl->validator, req->dl_etag[0] ? req->dl_etag : req->dl_last_modified);
+	dl->offset = req->dl_offset;
+	req->dl_started = true;
+	req->dl_progress = http_dl_step(dl);
+	LOG_INF("HTTP %d: Download from %d of %d", req->fd, dl->offset, dl->total);
+	urc_send_to(req->pipe, "\r\n#XHTTPCRANGE: %d,%d,%d\r\n", req->fd, dl->offset, dl->total);
+
+	return 0;
+}
+
+/* Forget a download when its response completed, keep it when it was interrupted. */
+static void http_dl_finish(struct http_request *req)
+{
+	struct http_dl *dl = req->dl;
+	bool complete;
+
+	if (!dl || !req->dl_started) {
+		return;
+	}
+
+	if (req->chunked) {
+		complete = sm_http_chunked_done(&req->chunked_dec);
+	} else if (req->content_length >= 0) {
+		complete = req->bytes_sent >= req->content_length;
+	} else {
+		complete = req->server_closed;
+	}
+
+	if (complete) {
+		dl->url[0] = '\0';
+	} else {
+		LOG_INF("HTTP %d: Download interrupted at %d", req->fd, dl->offset);
+	}
+}
+
+/* Range request headers to resume a download, or NULL to download from the start. */
+static char *http_dl_range_headers(struct http_request *req)
+{
+	struct http_dl *dl = req->dl;
+	char *hdr;
+	size_t len;
+
+	/* Without a validator, a resumed download could mix two versions of the resource. */
+	if (dl->offset == 0 || dl->validator[0] == '\0') {
+		return NULL;
+	}
+
+	len = sizeof("Range: bytes=2147483647-\r\nIf-Range: \r\n") + strlen(dl->validator);
+	hdr = malloc(len);
+	if (hdr) {
+		snprintf(hdr, len, "Range: bytes=%d-\r\nIf-Range: %s\r\n", dl->offset,
+			 dl->validator);
+		req->dl_offset = dl->offset;
+	}
+
+	return hdr;
+}
+#endif /* CONFIG_SM_HTTPC_DL */
+
 static bool http_any_active_request_unlocked(void)
 {
 	for (int i = 0; i < HTTP_MAX_REQUESTS; i++) {
@@ -180,39 +600,96 @@ static void http_timeout_work_fn(struct k_work *work)
 /* Find request by socket fd */
 static struct http_request *find_request(int fd)
 {
-	for (int i = 0; i < HTTP_MAX_REQUESTS; i++) {
-		if (http_requests[i] && http_requests[i]->fd == fd) {
-			return http_requests[i];
-		}
+	int slot = find_socket_slot(fd);
+
+	if (slot < 0 || slot >= HTTP_MAX_REQUESTS) {
+		return NULL;
+	}
+	if (http_requests[slot] && http_requests[slot]->fd == fd) {
+		return http_requests[slot];
 	}
 	return NULL;
 }
 
-/* Allocate new request */
-static struct http_request *alloc_request(void)
+static struct http_request *new_request(void)
 {
-	for (int i = 0; i < HTTP_MAX_REQUESTS; i++) {
-		if (!http_requests[i]) {
-			http_requests[i] = malloc(sizeof(struct http_request));
-			if (!http_requests[i]) {
-				return NULL;
-			}
-			memset(http_requests[i], 0, sizeof(struct http_request));
-			http_requests[i]->recv_buf = malloc(HTTP_RECV_BUF_SIZE);
-			if (!http_requests[i]->recv_buf) {
-				free(http_requests[i]);
-				http_requests[i] = NULL;
-				return NULL;
-			}
-			http_requests[i]->fd = -1;
-			http_requests[i]->state = HTTP_STATE_IDLE;
-			http_requests[i]->content_length = -1;
-			http_requests[i]->pipe = sm_at_host_get_current_pipe();
-			return http_requests[i];
-		}
+	struct http_request *req = malloc(sizeof(struct http_request));
+
+	if (!req) {
+		return NULL;
+	}
+	memset(req, 0, sizeof(struct http_request));
+	req->fd = -1;
+	req->state = HTTP_STATE_IDLE;
+	req->content_length = -1;
+	req->keep_alive_timeout = -1;
+	req->pipe = sm_at_host_get_current_pipe();
+	sm_http_header_init(&req->header, http_header_field, req);
+#if defined(CONFIG_SM_HTTPC_DL)
+	req->dl_range_start = -1;
+	req->dl_range_total = -1;
+#endif
+	return req;
+}
+
+/* Allocate new request for a socket */
+static struct http_request *alloc_request(int fd)
+{
+	int slot = find_socket_slot(fd);
+
+	if (slot < 0 || slot >= HTTP_MAX_REQUESTS || http_requests[slot]) {
+		return NULL;
 	}
 
-	return NULL;
+	http_requests[slot] = new_request();
+	if (!http_requests[slot]) {
+		return NULL;
+	}
+	http_requests[slot]->recv_buf = malloc(HTTP_RECV_BUF_SIZE);
+	if (!http_requests[slot]->recv_buf) {
+		free(http_requests[slot]);
+		http_requests[slot] = NULL;
+		return NULL;
+	}
+	return http_requests[slot];
+}
+
+/* Check whether a request can be pipelined after the requests of a socket. */
+static bool can_pipeline(const struct http_request *head)
+{
+	int depth = 0;
+
+	/* The response of a manual mode request is pulled by the host, and a request body
+	 * is streamed in data mode, so nothing can be sent or received after them.
+	 */
+	if (head->manual_mode || head->state == HTTP_STATE_SENDING_BODY ||
+	    head->connection_close || head->server_closed) {
+		return false;
+	}
+	for (const struct http_request *req = head; req; req = req->next) {
+		depth++;
+	}
+
+	return depth < CONFIG_SM_HTTPC_PIPELINE_DEPTH;
+}
+
+/* Allocate new request pipelined after the requests of a socket. The receive buffer is
+ * handed over when the request before it completes.
+ */
+static struct http_request *queue_request(struct http_request *head)
+{
+	struct http_request *req = new_request();
+	struct http_request *last = head;
+
+	if (!req) {
+		return NULL;
+	}
+	while (last->next) {
+		last = last->next;
+	}
+	req->fd = head->fd;
+	last->next = req;
+	return req;
 }
 
 /* Parse URL into components */
@@ -244,23 +721,18 @@ static int http_parse_url_components(const char *url, size_t url_len, struct htt
 		return -EINVAL;
 	}
 
-	/* Extract port if specified */
+	if (parser.field_set & (1 << UF_SCHEMA)) {
+		unsigned int schema_len = parser.field_data[UF_SCHEMA].len;
+		const char *scheme_start = url + parser.field_data[UF_SCHEMA].off;
+
+		req->tls = schema_len == 5 && strncmp(scheme_start, "https", 5) == 0;
+	}
+
+	/* Extract port if specified, otherwise determine it based on scheme */
 	if (parser.field_set & (1 << UF_PORT)) {
 		req->port = parser.port;
 	} else {
-		/* Determine port based on scheme */
-		if (parser.field_set & (1 << UF_SCHEMA)) {
-			unsigned int schema_len = parser.field_data[UF_SCHEMA].len;
-			const char *scheme_start = url + parser.field_data[UF_SCHEMA].off;
-
-			if (schema_len == 5 && strncmp(scheme_start, "https", 5) == 0) {
-				req->port = 443;
-			} else {
-				req->port = 80;
-			}
-		} else {
-			req->port = 80;
-		}
+		req->port = req->tls ? 443 : 80;
 	}
 
 	/* Extract path (and query string if present, e.g. /foo?bar=1) */
@@ -318,9 +790,6 @@ static int http_build_request(struct http_request *req, char *buf, size_t buf_le
 	return len;
 }
 
-/* Compile-time length of a string literal (excludes null terminator) */
-#define STRLIT_LEN(s) (sizeof(s) - 1)
-
 /* Calculate the buffer size needed to hold the HTTP request headers */
 static size_t http_headers_size(const struct http_request *req)
 {
@@ -366,10 +835,13 @@ static int http_start_request(struct http_request *req)
 		return ret;
 	}
 
+	/* A pipelined request is sent by the XAPOLL thread once it is in the sending state. */
+	k_mutex_lock(&http_mutex, K_FOREVER);
 	req->send_ptr = req->send_buf;
 	req->send_remaining = ret;
 	req->state = HTTP_STATE_SENDING_REQUEST;
 	req->timeout_timestamp = k_uptime_get() + HTTP_RESPONSE_TIMEOUT_MS;
+	k_mutex_unlock(&http_mutex);
 
 	sock = find_socket(req->fd);
 	if (!sock) {
@@ -415,28 +887,44 @@ static void http_close_request(struct http_request *req)
 		req->send_buf = NULL;
 	}
 
-	if (req->fd >= 0) {
+	/* Unlink this request, the request pipelined after it takes its place. The lock is
+	 * taken also here, as the AT command handler closes requests without holding it.
+	 */
+	bool socket_idle = true;
+
+	k_mutex_lock(&http_mutex, K_FOREVER);
+	for (int i = 0; i < HTTP_MAX_REQUESTS; i++) {
+		struct http_request **link = &http_requests[i];
+
+		while (*link && *link != req) {
+			link = &(*link)->next;
+		}
+		if (*link) {
+			*link = req->next;
+			socket_idle = http_requests[i] == NULL;
+			break;
+		}
+	}
+#if defined(CONFIG_SM_HTTPC_DL)
+	http_dl_release(req);
+#endif
+	k_mutex_unlock(&http_mutex);
+
+	if (req->fd >= 0 && socket_idle) {
 		/* Stop XAPOLL events for this socket */
 		struct sm_socket *sock = find_socket(req->fd);
 
 		if (sock) {
 			xapoll_stop(sock);
 		}
-
-		req->fd = -1;
 	}
+	req->fd = -1;
+
 	/* Clear datamode_req if it points to this request */
 	if (datamode_req == req) {
 		datamode_req = NULL;
 	}
 
-	/* Free this request and clear its slot */
-	for (int i = 0; i < HTTP_MAX_REQUESTS; i++) {
-		if (http_requests[i] == req) {
-			http_requests[i] = NULL;
-			break;
-		}
-	}
 	free(req);
 }
 
@@ -461,18 +949,68 @@ static void http_send_cancel_status(struct http_request *req)
 		 req->bytes_sent, (int)req->connection_close);
 }
 
-/* Send error and close request */
+/* Send error and close request. The requests pipelined after it fail as well. */
 static void http_fail_request(struct http_request *req)
 {
-	http_send_error(req);
-	http_close_request(req);
+	while (req) {
+		struct http_request *next = req->next;
+
+		http_send_error(req);
+		http_close_request(req);
+		req = next;
+	}
+}
+
+/* Send cancel status and close all the requests of a socket */
+static void http_cancel_requests(int fd)
+{
+	struct http_request *req;
+
+	while ((req = find_request(fd)) != NULL) {
+		http_send_cancel_status(req);
+		http_close_request(req);
+	}
 }
 
-/* Send status URC and close request (successful completion) */
+/* Send status URC and close request (successful completion). The response of the request
+ * pipelined after it is received next, starting from the bytes left in the receive buffer.
+ */
 static void http_finish_request(struct http_request *req)
 {
+	struct http_request *next = req->next;
+
 	http_send_status(req);
+#if defined(CONFIG_SM_HTTPC_DL)
+	http_dl_finish(req);
+#endif
+	if (next) {
+		next->recv_buf = req->recv_buf;
+		next->recv_buf_len = req->recv_buf_len;
+		req->recv_buf = NULL;
+	}
+#if defined(CONFIG_SM_HTTPC_POOL)
+	else if (!req->connection_close && !req->server_closed) {
+		http_pool_put(req);
+	}
+#endif
 	http_close_request(req);
+	if (next) {
+		http_start_response(next);
+	}
+}
+
+/* Keep the bytes from @p offset on in the receive buffer. They do not belong to the
+ * response, but to the response of a pipelined request.
+ */
+static void http_keep_leftover(struct http_request *req, int offset)
+{
+	int left = req->recv_buf_len - offset;
+
+	if (left > 0) {
+		memmove(req->recv_buf, req->recv_buf + offset, left);
+		req->total_received -= left;
+	}
+	req->recv_buf_len = MAX(left, 0);
 }
 
 /* Send headers complete URC */
@@ -482,21 +1020,6 @@ static void http_send_headers_complete(struct http_request *req)
 		 req->content_length);
 }
 
-static void http_data_send_hex(struct modem_pipe *pipe, const uint8_t *buf, size_t len)
-{
-	char hex_buf[257];
-	size_t chunk = (sizeof(hex_buf) - 1) / 2;
-	size_t done = 0;
-
-	while (done < len) {
-		size_t n = MIN(chunk, len - done);
-		size_t sz = bin2hex(buf + done, n, hex_buf, sizeof(hex_buf));
-
-		data_send(pipe, hex_buf, sz);
-		done += n;
-	}
-}
-
 /* Send data URC followed by raw bytes or hex string */
 static void http_send_data(struct http_request *req, const uint8_t *data, int len)
 {
@@ -511,114 +1034,118 @@ static void http_send_data(struct http_request *req, const uint8_t *data, int le
 	rsp_send_to(req->pipe, "\r\n#XHTTPCDATA: %d,%d,%d\r\n", req->fd, req->bytes_sent, len);
 	req->bytes_sent += len;
 	if (req->hex_rx) {
-		http_data_send_hex(req->pipe, data, (size_t)len);
+		data_send_hex(req->pipe, data, (size_t)len);
 	} else {
 		data_send(req->pipe, data, len);
 	}
 	/* CRLF after the data chunk, consistent with socket auto-receive behaviour. */
 	rsp_send_to(req->pipe, "\r\n");
 	sm_at_host_unlock(req->pipe);
+#if defined(CONFIG_SM_HTTPC_DL)
+	http_dl_progress(req);
+#endif
 }
 
 /*
- * Detect HTTP/1.1 chunked transfer EOF marker in a body data buffer.
- * The final chunk is always "0\r\n\r\n" (zero-length chunk, RFC 9112 §7.1.1).
+ * Decode the chunked response body bytes received from @p start on in place (RFC 9112 §7.1).
+ * The bytes after the end of the body are kept right after the decoded bytes.
+ * Returns the number of decoded body bytes, or a negative error code.
  */
-static bool chunked_eof(const uint8_t *data, int len)
+static int http_body_decode(struct http_request *req, int start)
 {
-	return len >= 5 && memcmp(data + len - 5, "0\r\n\r\n", 5) == 0;
-}
-
-/* Parse HTTP status code from response buffer */
-static int parse_http_status_code(const char *buf, int *status_code)
-{
-	char *status_line;
+	size_t len = req->recv_buf_len - start;
+	size_t consumed;
 	int ret;
 
-	status_line = strstr(buf, "HTTP/1.");
-	if (!status_line) {
-		return -ENOENT;
+	ret = sm_http_chunked_decode(&req->chunked_dec, req->recv_buf + start, len, &consumed);
+	if (ret < 0) {
+		LOG_ERR("HTTP %d: Invalid chunked encoding", req->fd);
+		return ret;
 	}
-
-	ret = sscanf(status_line, "HTTP/1.%*d %d", status_code);
-	if (ret != 1) {
-		LOG_WRN("Failed to parse status code");
-		return -EINVAL;
+	if (consumed < len) {
+		memmove(req->recv_buf + start + ret, req->recv_buf + start + consumed,
+			len - consumed);
 	}
+	/* Only body bytes are counted, not the chunk framing. */
+	req->recv_buf_len -= consumed - ret;
+	req->total_received -= consumed - ret;
 
-	return 0;
+	return ret;
 }
 
-/* Parse Connection: close header from response buffer */
-static bool parse_connection_close(const char *buf, const char *header_end)
+/* Check whether a response header field is reported to the host. */
+static bool http_header_selected(const char *name, size_t name_len)
 {
-	const char *p;
+	const char *list = CONFIG_SM_HTTPC_RSP_HEADERS;
+
+	while (*list) {
+		const char *comma = strchr(list, ',');
+		size_t len = comma ? comma - list : strlen(list);
 
-	p = strstr(buf, "Connection: close");
-	if (!p) {
-		p = strstr(buf, "connection: close");
+		if (len == name_len && strncasecmp(list, name, len) == 0) {
+			return true;
+		}
+		list += comma ? len + 1 : len;
 	}
 
-	return p != NULL && p < header_end;
+	return false;
 }
 
-/* Parse Content-Length header from response buffer */
-static int parse_content_length(const char *buf, const char *header_end, int *length)
+/* Report the selected response header fields to the host, as they are parsed. */
+static void http_header_field(const char *name, size_t name_len, const char *value,
+			      size_t value_len, void *user_data)
 {
-	char *cl_header;
-	char *value_start;
-	int ret;
+	struct http_request *req = user_data;
 
-	cl_header = strstr(buf, "Content-Length:");
-	if (!cl_header) {
-		cl_header = strstr(buf, "content-length:");
+	if (http_header_selected(name, name_len)) {
+		urc_send_to(req->pipe, "\r\n#XHTTPCHDR: %d,\"%.*s\",\"%.*s\"\r\n", req->fd,
+			    (int)name_len, name, (int)value_len, value);
 	}
-
-	if (!cl_header || cl_header >= header_end) {
-		return -ENOENT;
-	}
-
-	value_start = cl_header + STRLIT_LEN("Content-Length:"); /* Skip "Content-Length:" */
-	while (*value_start == ' ') {
-		value_start++;
-	}
-
-	ret = sscanf(value_start, "%d", length);
-	if (ret != 1) {
-		return -EINVAL;
+#if defined(CONFIG_SM_HTTPC_DL)
+	if (req->dl) {
+		http_dl_field(req, name, name_len, value, value_len);
 	}
-
-	return 0;
+#endif
 }
 
 /* Called when the complete HTTP response header has been received.
- * Parses status/content-length, handles piggybacked body data, and notifies the host.
+ * Applies the parsed status/content-length, handles piggybacked body data, and notifies the host.
  * Returns true if the http request was finished (prematurely).
  */
-static bool http_headers_complete(struct http_request *req, char *header_end,
+static bool http_headers_complete(struct http_request *req, int body_offset,
 				  struct sm_socket *sock, bool hup)
 {
 	int ret;
-	int body_offset = header_end - (char *)req->recv_buf + STRLIT_LEN("\r\n\r\n");
 	int body_len = req->recv_buf_len - body_offset;
+	bool body_done;
 
-	ret = parse_http_status_code((char *)req->recv_buf, &req->status_code);
-	if (ret < 0) {
-		LOG_WRN("HTTP %d: Failed to parse status code: %d", req->fd, ret);
-	}
+	req->status_code = req->header.status_code;
 
-	ret = parse_content_length((char *)req->recv_buf, header_end, &req->content_length);
-	if (ret == 0) {
+	req->content_length = req->header.content_length;
+	if (req->content_length >= 0) {
 		LOG_INF("HTTP %d: Content-Length=%d", req->fd, req->content_length);
 	} else {
 		LOG_DBG("HTTP %d: No Content-Length header", req->fd);
 	}
 
-	req->connection_close = parse_connection_close((char *)req->recv_buf, header_end);
+	req->connection_close = req->header.connection_close;
 	if (req->connection_close) {
 		LOG_INF("HTTP %d: Server sent Connection: close", req->fd);
 	}
 
+	req->keep_alive_timeout = req->header.keep_alive_timeout;
+	if (req->keep_alive_timeout >= 0) {
+		LOG_DBG("HTTP %d: Keep-Alive timeout=%d", req->fd, req->keep_alive_timeout);
+	}
+
+	/* Transfer-Encoding overrides Content-Length (RFC 9112 §6.3). */
+	req->chunked = req->header.chunked;
+	if (req->chunked) {
+		LOG_DBG("HTTP %d: Chunked transfer coding", req->fd);
+		req->content_length = -1;
+		sm_http_chunked_init(&req->chunked_dec);
+	}
+
 	req->headers_complete = true;
 	req->state = HTTP_STATE_RECEIVING_BODY;
 
@@ -628,10 +1155,18 @@ static bool http_headers_complete(struct http_request *req, char *header_end,
 	 */
 	req->total_received -= body_offset;
 
+#if defined(CONFIG_SM_HTTPC_DL)
+	if (http_dl_headers(req) < 0) {
+		http_fail_request(req);
+		return true;
+	}
+#endif
+
 	http_send_headers_complete(req);
 
 	/* HEAD responses never carry a body (RFC 9110 §9.3.2). Finish now. */
 	if (req->method == HTTP_HEAD) {
+		http_keep_leftover(req, body_offset);
 		http_finish_request(req);
 		return true;
 	}
@@ -640,10 +1175,20 @@ static bool http_headers_complete(struct http_request *req, char *header_end,
 	if (req->status_code / 100 == 1 ||
 	    req->status_code == 204 ||
 	    req->status_code == 304) {
+		http_keep_leftover(req, body_offset);
 		http_finish_request(req);
 		return true;
 	}
 
+	if (req->chunked) {
+		ret = http_body_decode(req, body_offset);
+		if (ret < 0) {
+			http_fail_request(req);
+			return true;
+		}
+		body_len = ret;
+	}
+
 	if (req->manual_mode) {
 		/*
 		 * Keep piggybacked body bytes (if any) for the first pull.
@@ -660,12 +1205,26 @@ static bool http_headers_complete(struct http_request *req, char *header_end,
 		return true;
 	}
 
-	/* Auto mode: send any piggybacked body bytes immediately */
+	/* The end of a body without Content-Length is not known in advance, so the
+	 * responses of pipelined requests cannot be told apart from it.
+	 */
+	if (req->next && req->content_length < 0 && !req->chunked) {
+		LOG_ERR("HTTP %d: No Content-Length, pipelined requests failed", req->fd);
+		http_fail_request(req->next);
+	}
+
+	/* Auto mode: send any piggybacked body bytes immediately. Bytes beyond
+	 * Content-Length belong to the response of a pipelined request.
+	 */
+	if (req->content_length >= 0) {
+		body_len = MIN(body_len, req->content_length);
+	}
+	body_done = req->chunked && sm_http_chunked_done(&req->chunked_dec);
 	if (body_len > 0)
 		http_send_data(req, req->recv_buf + body_offset, body_len);
 
 	/* Clear buffer for next recv */
-	req->recv_buf_len = 0;
+	http_keep_leftover(req, body_offset + body_len);
 	LOG_DBG("HTTP %d: Headers complete, status %d", req->fd, req->status_code);
 
 	/*
@@ -683,13 +1242,11 @@ static bool http_headers_complete(struct http_request *req, char *header_end,
 
 	/*
 	 * Finish early when all body data is already in hand (piggybacked):
-	 * either content-length is satisfied, or chunked terminator was received.
+	 * either content-length is satisfied, or the last chunk was received.
 	 * With keep-alive connections there is no subsequent EOF to trigger the
 	 * completion check in the RECEIVING_BODY path.
 	 */
-	if ((req->content_length >= 0 && req->bytes_sent >= req->content_length) ||
-	    (req->content_length < 0 &&
-	     chunked_eof(req->recv_buf + body_offset, body_len))) {
+	if ((req->content_length >= 0 && req->bytes_sent >= req->content_length) || body_done) {
 		http_finish_request(req);
 		return true;
 	}
@@ -751,10 +1308,17 @@ static int http_recv_read(struct http_request *req, struct sm_socket *sock)
 static void http_process_recv_headers(struct http_request *req, struct sm_socket *sock,
 				      uint8_t events)
 {
-	char *header_end = strstr((char *)req->recv_buf, "\r\n\r\n");
+	/* Only the lines received since the previous call are parsed. */
+	int ret = sm_http_header_parse(&req->header, (char *)req->recv_buf, req->recv_buf_len);
 
-	if (header_end) {
-		if (http_headers_complete(req, header_end, sock, events & ZSOCK_POLLHUP)) {
+	if (ret < 0) {
+		LOG_ERR("HTTP %d: Invalid status line", req->fd);
+		http_fail_request(req);
+		return;
+	}
+
+	if (ret > 0) {
+		if (http_headers_complete(req, ret, sock, events & ZSOCK_POLLHUP)) {
 			return;
 		}
 		req->need_rearm_pollin = true;
@@ -771,9 +1335,24 @@ static void http_process_recv_headers(struct http_request *req, struct sm_socket
 }
 
 static void http_process_recv_body(struct http_request *req, struct sm_socket *sock,
-				    uint8_t events)
+				    uint8_t events, int received)
 {
 	bool body_done;
+	int len;
+
+	/* Decode the bytes just received, after the ones kept for manual mode pulls. */
+	if (req->chunked) {
+		int start = req->recv_buf_len - received;
+
+		len = http_body_decode(req, start);
+		if (len < 0) {
+			http_fail_request(req);
+			return;
+		}
+		if (req->manual_mode) {
+			req->recv_buf_len = start + len;
+		}
+	}
 
 	if (req->manual_mode) {
 		/*
@@ -787,12 +1366,21 @@ static void http_process_recv_body(struct http_request *req, struct sm_socket *s
 		return;
 	}
 
-	body_done = chunked_eof(req->recv_buf, req->recv_buf_len);
+	/* Bytes beyond the body belong to the response of a pipelined request. */
+	if (req->chunked) {
+		body_done = sm_http_chunked_done(&req->chunked_dec);
+	} else {
+		len = req->recv_buf_len;
+		if (req->content_length >= 0) {
+			len = MIN(len, req->content_length - req->bytes_sent);
+		}
+		body_done = false;
+	}
 
-	http_send_data(req, req->recv_buf, req->recv_buf_len);
-	req->recv_buf_len = 0;
+	http_send_data(req, req->recv_buf, len);
+	http_keep_leftover(req, len);
 
-	/* Finish if content-length satisfied, chunked EOF, or connection closing. */
+	/* Finish if content-length satisfied, last chunk received, or connection closing. */
 	if (body_done ||
 	    (req->content_length > 0 && req->bytes_sent >= req->content_length) ||
 	    (events & ZSOCK_POLLHUP)) {
@@ -803,6 +1391,75 @@ static void http_process_recv_body(struct http_request *req, struct sm_socket *s
 	req->need_rearm_pollin = true;
 }
 
+/* Start receiving the response of a pipelined request, after the response of the request
+ * before it completed. Bytes already received are processed right away.
+ */
+static void http_start_response(struct http_request *req)
+{
+	req->timeout_timestamp = k_uptime_get() + HTTP_RESPONSE_TIMEOUT_MS;
+	req->total_received = req->recv_buf_len;
+	req->recv_buf[req->recv_buf_len] = '\0';
+	req->need_rearm_pollin = true;
+
+	if (req->state == HTTP_STATE_RECEIVING_HEADERS && req->recv_buf_len > 0) {
+		struct sm_socket *sock = find_socket(req->fd);
+
+		if (!sock) {
+			http_fail_request(req);
+			return;
+		}
+		http_process_recv_headers(req, sock, 0);
+	}
+}
+
+/* Check whether a pipelined request of a socket has request headers left to send. */
+static bool http_send_pending(const struct http_request *head)
+{
+	for (const struct http_request *req = head->next; req; req = req->next) {
+		if (req->state == HTTP_STATE_SENDING_REQUEST) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Send the headers of pipelined requests in order, after the request of the socket that
+ * is receiving its response. Returns a negative error code if the requests failed.
+ */
+static int http_send_queued(struct http_request *head)
+{
+	if (head->state == HTTP_STATE_IDLE || head->state == HTTP_STATE_SENDING_REQUEST ||
+	    head->state == HTTP_STATE_SENDING_BODY) {
+		return 0;
+	}
+
+	for (struct http_request *req = head->next; req; req = req->next) {
+		if (req->state != HTTP_STATE_SENDING_REQUEST) {
+			continue;
+		}
+		while (req->send_remaining > 0) {
+			int ret = zsock_send(req->fd, req->send_ptr, req->send_remaining,
+					     MSG_DONTWAIT);
+
+			if (ret < 0) {
+				if (errno == EAGAIN || errno == EWOULDBLOCK) {
+					return 0;
+				}
+				LOG_ERR("Send failed: %d", errno);
+				http_fail_request(head);
+				return -EIO;
+			}
+			req->send_ptr += ret;
+			req->send_remaining -= ret;
+		}
+		req->state = HTTP_STATE_RECEIVING_HEADERS;
+		LOG_DBG("HTTP %d: Pipelined request sent", req->fd);
+	}
+
+	return 0;
+}
+
 /* Process HTTP request state machine (event-driven via XAPOLL) */
 static void http_process_request(struct http_request *req, uint8_t events)
 {
@@ -818,6 +1475,10 @@ static void http_process_request(struct http_request *req, uint8_t events)
 	LOG_DBG("HTTP %d: process_request state=%d events=0x%x time=%lld timeout=%lld", req->fd,
 		req->state, events, k_uptime_get(), req->timeout_timestamp);
 
+	if (events & ZSOCK_POLLHUP) {
+		req->server_closed = true;
+	}
+
 	/* POLLERR/POLLNVAL are always fatal; POLLHUP is handled per-state below. */
 	if (events & (ZSOCK_POLLERR | ZSOCK_POLLNVAL)) {
 		LOG_ERR("HTTP %d: Socket error (events=0x%x)", req->fd, events);
@@ -833,6 +1494,12 @@ static void http_process_request(struct http_request *req, uint8_t events)
 		return;
 	}
 
+	if ((events & ZSOCK_POLLOUT) && !(events & ZSOCK_POLLHUP) && req->next) {
+		if (http_send_queued(req)) {
+			return;
+		}
+	}
+
 	switch (req->state) {
 	case HTTP_STATE_SENDING_REQUEST:
 		/* Handle writable socket */
@@ -917,12 +1584,13 @@ static void http_process_request(struct http_request *req, uint8_t events)
 			return;
 		}
 		if (ret == 0) {
+			req->server_closed = true;
 			http_warn_incomplete_transfer(req);
 			http_finish_request(req);
 			return;
 		}
 
-		http_process_recv_body(req, sock, events);
+		http_process_recv_body(req, sock, events, ret);
 		break;
 
 	case HTTP_STATE_IDLE:
@@ -936,6 +1604,17 @@ static void http_process_request(struct http_request *req, uint8_t events)
 }
 
 /* Public function called by socket layer when poll events occur */
+bool sm_at_httpc_owns(int fd)
+{
+	bool owns;
+
+	k_mutex_lock(&http_mutex, K_FOREVER);
+	owns = find_request(fd) != NULL;
+	k_mutex_unlock(&http_mutex);
+
+	return owns;
+}
+
 bool sm_at_httpc_poll_event(int fd, uint8_t events)
 {
 	struct http_request *req = NULL;
@@ -951,6 +1630,11 @@ bool sm_at_httpc_poll_event(int fd, uint8_t events)
 		req = find_request(fd);
 	}
 
+	/* Keep POLLOUT armed while pipelined requests wait to be sent */
+	if (req && http_send_pending(req)) {
+		set_xapoll_events(find_socket(fd), ZSOCK_POLLOUT | ZSOCK_POLLIN);
+	}
+
 	k_mutex_unlock(&http_mutex);
 
 	return (req && req->need_rearm_pollin);
@@ -961,11 +1645,13 @@ void sm_at_httpc_socket_closed(int fd)
 	k_mutex_lock(&http_mutex, K_FOREVER);
 	struct http_request *req = find_request(fd);
 
+#if defined(CONFIG_SM_HTTPC_POOL)
+	http_pool_remove(fd);
+#endif
 	if (req) {
 		LOG_WRN("HTTP %d: socket closed with active request (state=%d); cleaning up",
 			fd, req->state);
-		http_send_cancel_status(req);
-		http_close_request(req);
+		http_cancel_requests(fd);
 	}
 	k_mutex_unlock(&http_mutex);
 }
@@ -1090,6 +1776,96 @@ static int http_datamode_callback(uint8_t op, const uint8_t *data, int len, uint
 	return 0;
 }
 
+/* Take a new request for a URL on a socket, pipelined after the active request of the
+ * socket if there is one. With the pool handle, an idle connection to the server of the URL
+ * is used, and @p fd is set to its socket. The URL is parsed before anything is taken,
+ * so that an invalid URL leaves a pooled connection in the pool.
+ */
+static int http_claim_request(int *fd, const char *url, size_t url_len,
+			      struct http_request **req_out, bool *pipelined)
+{
+	struct http_request *req;
+	struct http_request parsed = {0};
+	int socket_fd = *fd;
+	int err;
+
+	if (url_len == 0 || url_len >= HTTP_URL_MAX_LEN) {
+		LOG_ERR("URL length invalid: %zu", url_len);
+		return -EINVAL;
+	}
+
+	err = http_parse_url_components(url, url_len, &parsed);
+	if (err) {
+		goto error;
+	}
+
+#if defined(CONFIG_SM_HTTPC_POOL)
+	/* Take an idle connection to the server of the URL from the pool */
+	if (socket_fd == HTTP_POOL_HANDLE) {
+		socket_fd = http_pool_find_url(&parsed);
+		if (socket_fd < 0) {
+			LOG_ERR("No pooled connection for URL");
+			err = socket_fd;
+			goto error;
+		}
+	}
+#endif
+
+	/* Validate socket exists */
+	if (!find_socket(socket_fd)) {
+		LOG_ERR("Invalid socket fd: %d", socket_fd);
+		err = -EINVAL;
+		goto error;
+	}
+
+	/* Pipeline the request if a request is already active on this socket,
+	 * otherwise allocate the new request slot atomically.  find_request(),
+	 * queue_request() and alloc_request() touch http_requests[], so they must
+	 * be performed under the same lock to prevent races with
+	 * http_process_request() running on the XAPOLL thread.
+	 */
+	k_mutex_lock(&http_mutex, K_FOREVER);
+	req = find_request(socket_fd);
+	*pipelined = req != NULL;
+	if (*pipelined) {
+		if (!can_pipeline(req)) {
+			k_mutex_unlock(&http_mutex);
+			LOG_ERR("Request already active on socket %d", socket_fd);
+			err = -EBUSY;
+			goto error;
+		}
+		req = queue_request(req);
+	} else {
+		req = alloc_request(socket_fd);
+#if defined(CONFIG_SM_HTTPC_POOL)
+		if (req) {
+			http_pool_use(socket_fd);
+		}
+#endif
+	}
+	k_mutex_unlock(&http_mutex);
+	if (!req) {
+		LOG_ERR("No free request slots");
+		err = -ENOMEM;
+		goto error;
+	}
+
+	req->hostname = parsed.hostname;
+	req->path = parsed.path;
+	req->port = parsed.port;
+	req->tls = parsed.tls;
+	*fd = socket_fd;
+	*req_out = req;
+
+	return 0;
+
+error:
+	free(parsed.hostname);
+	free(parsed.path);
+
+	return err;
+}
+
 /**
  * Start an asynchronous HTTP or HTTPS request on a connected AT socket.
  * Returns OK immediately; headers arrive as #XHTTPCHEAD and body as #XHTTPCDATA/#XHTTPCSTAT.
@@ -1104,7 +1880,7 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 	size_t url_len;
 	int method;
 	struct http_request *req;
-	struct sm_socket *sock;
+	bool pipelined;
 
 	switch (cmd_type) {
 	case AT_PARSER_CMD_TYPE_SET: {
@@ -1112,59 +1888,23 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 			return -EINVAL;
 		}
 
-		/* Get socket FD */
+		/* Get socket FD and URL */
 		err = at_parser_num_get(parser, 1, &socket_fd);
 		if (err) {
 			return err;
 		}
-
-		/* Validate socket exists */
-		sock = find_socket(socket_fd);
-		if (!sock) {
-			LOG_ERR("Invalid socket fd: %d", socket_fd);
-			return -EINVAL;
-		}
-
-		/* Reject if a request is already active on this socket, and allocate
-		 * the new request slot atomically.  Both find_request() and
-		 * alloc_request() touch http_requests[], so they must be performed
-		 * under the same lock to prevent races with http_process_request()
-		 * running on the XAPOLL thread.
-		 */
-		k_mutex_lock(&http_mutex, K_FOREVER);
-		if (find_request(socket_fd)) {
-			k_mutex_unlock(&http_mutex);
-			LOG_ERR("Request already active on socket %d", socket_fd);
-			return -EBUSY;
-		}
-		req = alloc_request();
-		k_mutex_unlock(&http_mutex);
-		if (!req) {
-			LOG_ERR("No free request slots");
-			return -ENOMEM;
-		}
-
-		/* Get URL */
 		err = at_parser_string_ptr_get(parser, 2, &url, &url_len);
 		if (err) {
-			http_close_request(req);
 			return err;
 		}
-		if (url_len == 0 || url_len >= HTTP_URL_MAX_LEN) {
-			LOG_ERR("URL length invalid: %zu", url_len);
-			http_close_request(req);
-			return -EINVAL;
-		}
 
 		/* Get method */
 		err = at_parser_num_get(parser, 3, &method);
 		if (err) {
-			http_close_request(req);
 			return err;
 		}
 
 		if (method < HTTP_GET || method > HTTP_HEAD) {
-			http_close_request(req);
 			return -EINVAL;
 		}
 
@@ -1176,7 +1916,6 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 		if (param_count > next_param_idx) {
 			if (at_parser_num_get(parser, next_param_idx, &auto_reception) == 0) {
 				if (auto_reception != 0 && auto_reception != 1) {
-					http_close_request(req);
 					return -EINVAL;
 				}
 				next_param_idx++;
@@ -1190,7 +1929,6 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 		if (param_count > next_param_idx) {
 			if (at_parser_num_get(parser, next_param_idx, &format) == 0) {
 				if (format != 0 && format != 1) {
-					http_close_request(req);
 					return -EINVAL;
 				}
 				next_param_idx++;
@@ -1208,23 +1946,17 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 				if (method == HTTP_POST || method == HTTP_PUT) {
 					if (body_len < 0) {
 						LOG_ERR("Invalid body_len: %d", body_len);
-						http_close_request(req);
 						return -EINVAL;
 					}
 				} else if (body_len != 0) {
 					LOG_ERR("body_len must be 0 for method %d", method);
-					http_close_request(req);
 					return -EINVAL;
 				}
 				next_param_idx++;
 			}
 		}
 
-		/* Setup request */
-		req->fd = socket_fd;
-		req->method = method;
-
-		/* Parse extra headers (remaining string params) */
+		/* Check the size of the extra headers (remaining string params) */
 		size_t headers_total_len = 0;
 
 		for (int i = next_param_idx; i <= param_count; i++) {
@@ -1240,11 +1972,29 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 			if (headers_total_len + 1 > HTTP_EXTRA_HEADERS_SIZE) {
 				LOG_ERR("Extra headers too large (%zu > %d)", headers_total_len + 1,
 					HTTP_EXTRA_HEADERS_SIZE);
-				http_close_request(req);
 				return -ENOMEM;
 			}
 		}
 
+		/* Claim the request only once the parameters are valid, so that an invalid
+		 * command leaves a pooled connection in the pool.
+		 */
+		err = http_claim_request(&socket_fd, url, url_len, &req, &pipelined);
+		if (err) {
+			return err;
+		}
+
+		/* Pipelined requests have their response received automatically, and no body */
+		if (pipelined && (!auto_reception || body_len > 0)) {
+			LOG_ERR("Request already active on socket %d", socket_fd);
+			http_close_request(req);
+			return -EBUSY;
+		}
+
+		/* Setup request */
+		req->fd = socket_fd;
+		req->method = method;
+
 		if (headers_total_len > 0) {
 			char *hdr;
 			size_t pos = 0;
@@ -1284,13 +2034,6 @@ STATIC int handle_at_httpcreq(enum at_parser_cmd_type cmd_type, struct at_parser
 
 		req->hex_rx = (bool)format;
 
-		/* Parse URL */
-		err = http_parse_url_components(url, url_len, req);
-		if (err) {
-			http_close_request(req);
-			return err;
-		}
-
 		/* For POST/PUT with body, send headers now then stream body via data mode */
 		if ((method == HTTP_POST || method == HTTP_PUT) && body_len > 0) {
 			LOG_INF("Streaming %d bytes body", body_len);
@@ -1351,7 +2094,6 @@ static int pull_data(int socket_fd, int pull_len)
 {
 	struct http_request *req;
 	int ret;
-	int last_sent = 0; /* Bytes forwarded to host in this call. Used for chunked EOF check */
 
 	k_mutex_lock(&http_mutex, K_FOREVER);
 	req = find_request(socket_fd);
@@ -1388,7 +2130,7 @@ static int pull_data(int socket_fd, int pull_len)
 		rsp_send("\r\n#XHTTPCDATA: %d,%d,%d\r\n", req->fd, req->bytes_sent, send_len);
 		req->bytes_sent += send_len;
 		if (req->hex_rx) {
-			http_data_send_hex(req->pipe, req->recv_buf, (size_t)send_len);
+			data_send_hex(req->pipe, req->recv_buf, (size_t)send_len);
 		} else {
 			data_send(req->pipe, req->recv_buf, send_len);
 		}
@@ -1396,7 +2138,6 @@ static int pull_data(int socket_fd, int pull_len)
 		if (req->recv_buf_len > 0) {
 			memmove(req->recv_buf, req->recv_buf + send_len, req->recv_buf_len);
 		}
-		last_sent = send_len;
 		goto check_complete;
 	}
 
@@ -1418,6 +2159,7 @@ static int pull_data(int socket_fd, int pull_len)
 
 	if (ret == 0) {
 		/* EOF - connection closed by server */
+		req->server_closed = true;
 		http_finish_request(req);
 		k_mutex_unlock(&http_mutex);
 		return 0;
@@ -1425,14 +2167,24 @@ static int pull_data(int socket_fd, int pull_len)
 
 	req->total_received += ret;
 	req->timeout_timestamp = k_uptime_get() + HTTP_RESPONSE_TIMEOUT_MS;
+	if (req->chunked) {
+		/* Only the decoded body bytes are sent, bytes after the body are dropped. */
+		req->recv_buf_len = ret;
+		ret = http_body_decode(req, 0);
+		req->recv_buf_len = 0;
+		if (ret < 0) {
+			http_fail_request(req);
+			k_mutex_unlock(&http_mutex);
+			return ret;
+		}
+	}
 	rsp_send("\r\n#XHTTPCDATA: %d,%d,%d\r\n", req->fd, req->bytes_sent, ret);
 	req->bytes_sent += ret;
 	if (req->hex_rx) {
-		http_data_send_hex(req->pipe, req->recv_buf, (size_t)ret);
+		data_send_hex(req->pipe, req->recv_buf, (size_t)ret);
 	} else {
 		data_send(req->pipe, req->recv_buf, ret);
 	}
-	last_sent = ret;
 
 check_complete:
 	if (req->content_length > 0 && req->bytes_sent >= req->content_length) {
@@ -1441,14 +2193,10 @@ check_complete:
 		return 0;
 	}
 
-	/* For chunked transfer (no Content-Length), detect the terminal "0\r\n\r\n"
-	 * marker in the last forwarded block.  Only check when recv_buf is fully
-	 * drained (recv_buf_len == 0): if a partial drain left bytes in the buffer,
-	 * the terminator may still be in the remaining data, not at the end of what
-	 * was just sent.
+	/* For chunked transfer, finish when the last chunk has been decoded and all the
+	 * decoded body bytes have been sent to the host.
 	 */
-	if (req->content_length < 0 && req->recv_buf_len == 0 &&
-	    last_sent > 0 && chunked_eof(req->recv_buf, last_sent)) {
+	if (req->chunked && req->recv_buf_len == 0 && sm_http_chunked_done(&req->chunked_dec)) {
 		http_finish_request(req);
 		k_mutex_unlock(&http_mutex);
 		return 0;
@@ -1525,8 +2273,7 @@ STATIC int handle_at_httpccancel(enum at_parser_cmd_type cmd_type, struct at_par
 		req = find_request(socket_fd);
 		if (req) {
 			LOG_INF("Cancelling HTTP request fd=%d", socket_fd);
-			http_send_cancel_status(req);
-			http_close_request(req);
+			http_cancel_requests(socket_fd);
 			k_mutex_unlock(&http_mutex);
 		} else {
 			k_mutex_unlock(&http_mutex);
@@ -1546,3 +2293,147 @@ STATIC int handle_at_httpccancel(enum at_parser_cmd_type cmd_type, struct at_par
 
 	return err;
 }
+
+#if defined(CONFIG_SM_HTTPC_POOL)
+/* AT#XHTTPCPOOL - read connection pool statistics */
+SM_AT_CMD_CUSTOM(xhttpcpool, "AT#XHTTPCPOOL", handle_at_httpcpool);
+STATIC int handle_at_httpcpool(enum at_parser_cmd_type cmd_type, struct at_parser *parser,
+			       uint32_t param_count)
+{
+	int idle = 0;
+
+	ARG_UNUSED(parser);
+	ARG_UNUSED(param_count);
+
+	if (cmd_type != AT_PARSER_CMD_TYPE_SET) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&http_mutex, K_FOREVER);
+	for (int i = 0; i < CONFIG_SM_HTTPC_POOL_SIZE; i++) {
+		if (http_pool[i].fd >= 0) {
+			idle++;
+		}
+	}
+	rsp_send("\r\n#XHTTPCPOOL: %d,%d,%u,%u\r\n", CONFIG_SM_HTTPC_POOL_SIZE, idle,
+		 http_pool_hits, http_pool_misses);
+	k_mutex_unlock(&http_mutex);
+
+	return 0;
+}
+#endif /* CONFIG_SM_HTTPC_POOL */
+
+#if defined(CONFIG_SM_HTTPC_DL)
+/**
+ * Start a resumable download with a GET request on a connected AT socket.
+ * An interrupted download of the same URL continues with a Range request.
+ */
+SM_AT_CMD_CUSTOM(xhttpcdl, "AT#XHTTPCDL", handle_at_httpcdl);
+STATIC int handle_at_httpcdl(enum at_parser_cmd_type cmd_type, struct at_parser *parser,
+			     uint32_t param_count)
+{
+	int err;
+	int socket_fd;
+	const char *url;
+	size_t url_len;
+	int format = 0;
+	struct http_request *req;
+	struct http_dl *dl;
+	bool pipelined;
+
+	switch (cmd_type) {
+	case AT_PARSER_CMD_TYPE_SET:
+		/* AT#XHTTPCDL=<url> forgets the download of the URL. */
+		if (param_count == 2 && at_parser_string_ptr_get(parser, 1, &url, &url_len) == 0) {
+			k_mutex_lock(&http_mutex, K_FOREVER);
+			err = http_dl_forget(url, url_len);
+			k_mutex_unlock(&http_mutex);
+			break;
+		}
+
+		if (param_count < 3) {
+			return -EINVAL;
+		}
+
+		err = at_parser_num_get(parser, 1, &socket_fd);
+		if (err) {
+			return err;
+		}
+		err = at_parser_string_ptr_get(parser, 2, &url, &url_len);
+		if (err) {
+			return err;
+		}
+		if (param_count > 3) {
+			err = at_parser_num_get(parser, 3, &format);
+			if (err) {
+				return err;
+			}
+			if (format != 0 && format != 1) {
+				return -EINVAL;
+			}
+		}
+
+		if (url_len == 0 || url_len >= HTTP_URL_MAX_LEN) {
+			LOG_ERR("URL length invalid: %zu", url_len);
+			return -EINVAL;
+		}
+
+		k_mutex_lock(&http_mutex, K_FOREVER);
+		err = http_dl_get(url, url_len, &dl);
+		k_mutex_unlock(&http_mutex);
+		if (err) {
+			LOG_ERR("No download entry for URL: %d", err);
+			return err;
+		}
+
+		err = http_claim_request(&socket_fd, url, url_len, &req, &pipelined);
+		if (err) {
+			k_mutex_lock(&http_mutex, K_FOREVER);
+			http_dl_put(dl);
+			k_mutex_unlock(&http_mutex);
+			return err;
+		}
+		req->fd = socket_fd;
+		req->method = HTTP_GET;
+		req->hex_rx = (bool)format;
+		req->dl = dl;
+
+		req->extra_headers = http_dl_range_headers(req);
+		if (req->extra_headers) {
+			LOG_INF("HTTP %d: Resuming download at %d", req->fd, req->dl_offset);
+		}
+
+		err = http_start_request(req);
+		if (err) {
+			http_close_request(req);
+			return err;
+		}
+
+		rsp_send("\r\n#XHTTPCDL: %d\r\n", req->fd);
+		break;
+
+	case AT_PARSER_CMD_TYPE_READ:
+		k_mutex_lock(&http_mutex, K_FOREVER);
+		for (int i = 0; i < CONFIG_SM_HTTPC_DL_COUNT; i++) {
+			if (http_dls[i].url[0] != '\0') {
+				rsp_send("\r\n#XHTTPCDL: \"%s\",%d,%d\r\n", http_dls[i].url,
+					 http_dls[i].offset, http_dls[i].total);
+			}
+		}
+		k_mutex_unlock(&http_mutex);
+		err = 0;
+		break;
+
+	case AT_PARSER_CMD_TYPE_TEST:
+		rsp_send("\r\n#XHTTPCDL: <handle>,<url>[,<format>]\r\n");
+		err = 0;
+		break;
+
+	default:
+		err = -EINVAL;
+		break;
+	}
+
+	return err;
+}
+#endif /* CONFIG_SM_HTTPC_DL */
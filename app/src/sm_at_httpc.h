@@ -16,6 +16,14 @@
  * @{
  */
 
+/**
+ * @brief Check whether the HTTP client has a request on a socket.
+ *
+ * @param fd Socket file descriptor
+ * @return true if a request is active on @p fd
+ */
+bool sm_at_httpc_owns(int fd);
+
 /**
  * @brief Notify HTTP client of poll events (called from socket layer)
  *
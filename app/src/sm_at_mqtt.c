@@ -54,7 +54,7 @@ static uint16_t mqtt_broker_port;
 static char mqtt_clientid[MQTT_MAX_CID_LEN + 1];
 static char mqtt_username[SM_MAX_USERNAME + 1];
 static char mqtt_password[SM_MAX_PASSWORD + 1];
-extern uint8_t sm_data_buf[SM_MAX_MESSAGE_SIZE]; /* TODO: replace with something else */
+static uint8_t mqtt_data_buf[SM_MAX_MESSAGE_SIZE];
 static struct mqtt_publish_param pub_param;
 static uint8_t pub_topic[MQTT_MAX_TOPIC_LEN];
 
@@ -104,9 +104,9 @@ static int handle_mqtt_publish_evt(struct mqtt_client *const c, const struct mqt
 		evt->param.publish.message.topic.topic.size);
 	data_send(ctx.pipe, "\r\n", 2);
 	do {
-		ret = mqtt_read_publish_payload_blocking(c, sm_data_buf, sizeof(sm_data_buf));
+		ret = mqtt_read_publish_payload_blocking(c, mqtt_data_buf, sizeof(mqtt_data_buf));
 		if (ret > 0) {
-			data_send(ctx.pipe, sm_data_buf, ret);
+			data_send(ctx.pipe, mqtt_data_buf, ret);
 			size_read += ret;
 		}
 	} while (ret >= 0 && size_read < evt->param.publish.message.payload.len);
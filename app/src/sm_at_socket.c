@@ -61,6 +61,8 @@ enum sm_socket_send_result_mode {
 
 static char udp_url[SM_MAX_URL];
 static uint16_t udp_port;
+/* Peer of UDP data mode, resolved once when data mode is entered. */
+static struct net_sockaddr udp_peer;
 
 struct sm_async_poll {
 	uint8_t events;                  /* Events to poll for this socket. */
@@ -92,22 +94,43 @@ static struct sm_socket {
 	bool send_cb_set: 1;             /* Send callback set */
 	bool connected: 1;               /* Connected flag. */
 	bool listen: 1;                  /* Listen flag for TCP server sockets. */
+	uint16_t recv_max;               /* Maximum read size, 0 for the default. */
 	struct sm_async_poll async_poll; /* Async poll info. */
 	struct sm_send_ntf send_ntf;     /* Send notification info. */
 	struct modem_pipe *pipe;	 /* AT pipe associated with this socket */
 } socks[SM_MAX_SOCKET_COUNT];
 
+/* Sockets by descriptor. Descriptors are small integers, larger ones are looked up from socks. */
+#define SOCK_FD_MAP_SIZE 32
+static struct sm_socket *sock_fd_map[SOCK_FD_MAP_SIZE];
+
 static uint8_t bin_data[1400]; /* Buffer for hex2bin data conversion */
-uint8_t sm_data_buf[SM_MAX_MESSAGE_SIZE];
+
+/* Receive buffers, leased for the duration of a read so that sockets are received in parallel. */
+K_MEM_SLAB_DEFINE_STATIC(recv_buf_slab, CONFIG_SM_SOCKET_RX_MAX_SIZE, CONFIG_SM_SOCKET_RX_BUF_COUNT,
+			 4);
+#define RECV_BUF_LEASE_TMO K_SECONDS(10)
 
 /* forward declarations */
 #define SOCKET_SEND_TMO_SEC 30
 
 static int do_recv(struct sm_socket *sock, int timeout, int flags,
-		   enum sm_socket_mode mode, size_t data_len);
+		   enum sm_socket_mode mode, size_t data_len, bool crlf);
 
 static int do_recvfrom(struct sm_socket *sock, int timeout, int flags,
-		       enum sm_socket_mode mode, size_t data_len);
+		       enum sm_socket_mode mode, size_t data_len, bool crlf);
+
+/* Set the descriptor of a socket and keep the descriptor map up to date. */
+static void set_socket_fd(struct sm_socket *sock, int fd)
+{
+	if (sock->fd >= 0 && sock->fd < SOCK_FD_MAP_SIZE && sock_fd_map[sock->fd] == sock) {
+		sock_fd_map[sock->fd] = NULL;
+	}
+	sock->fd = fd;
+	if (fd >= 0 && fd < SOCK_FD_MAP_SIZE) {
+		sock_fd_map[fd] = sock;
+	}
+}
 
 static void init_socket(struct sm_socket *socket)
 {
@@ -118,13 +141,14 @@ static void init_socket(struct sm_socket *socket)
 	socket->role = AT_SOCKET_ROLE_CLIENT;
 	socket->sec_tag = SEC_TAG_TLS_INVALID;
 	socket->family = AF_UNSPEC;
-	socket->fd = INVALID_SOCKET;
+	set_socket_fd(socket, INVALID_SOCKET);
 	socket->cid = 0;
 	socket->local_port = 0;
 	socket->send_flags = 0;
 	socket->send_cb_set = false;
 	socket->connected = false;
 	socket->listen = false;
+	socket->recv_max = 0;
 	socket->send_ntf = (struct sm_send_ntf){0};
 	socket->async_poll = (struct sm_async_poll){0};
 	socket->pipe = sm_at_host_get_current_pipe();
@@ -132,6 +156,13 @@ static void init_socket(struct sm_socket *socket)
 
 struct sm_socket *find_socket(int fd)
 {
+	if (fd < 0) {
+		return NULL;
+	}
+	if (fd < SOCK_FD_MAP_SIZE) {
+		return sock_fd_map[fd];
+	}
+
 	for (int i = 0; i < SM_MAX_SOCKET_COUNT; i++) {
 		if (socks[i].fd == fd) {
 			return &socks[i];
@@ -141,6 +172,13 @@ struct sm_socket *find_socket(int fd)
 	return NULL;
 }
 
+int find_socket_slot(int fd)
+{
+	struct sm_socket *sock = find_socket(fd);
+
+	return sock ? sock - socks : -1;
+}
+
 static struct sm_socket *find_avail_socket(void)
 {
 	for (int i = 0; i < SM_MAX_SOCKET_COUNT; i++) {
@@ -152,6 +190,12 @@ static struct sm_socket *find_avail_socket(void)
 	return NULL;
 }
 
+/* Maximum amount of data to read from a socket at once. */
+static size_t recv_max_get(const struct sm_socket *sock)
+{
+	return sock->recv_max ? sock->recv_max : CONFIG_SM_SOCKET_RX_MAX_SIZE;
+}
+
 static struct async_poll_ctx *poll_ctx_from_sock(struct sm_socket *sock)
 {
 	if (sock == NULL) {
@@ -201,6 +245,7 @@ static void poll_cb(const struct socket_ncs_pollcb_params *pollfd)
 	}
 
 	atomic_or(&sock->async_poll.revents, pollfd->revents);
+	atomic_set_bit(&poll_ctx->ready, sock - socks);
 
 	k_work_submit_to_queue(&sm_work_q, &poll_ctx->poll_work);
 }
@@ -244,25 +289,20 @@ static void auto_reception(struct sm_socket *sock)
 
 	sm_at_host_lock(sock->pipe);
 
+	/* <CR><LF> after the data. */
 	if (sock->connected || sock->type == SOCK_RAW) {
 		err = do_recv(sock, 0, MSG_DONTWAIT,
 			      sock->async_poll.adr_hex ? AT_SOCKET_MODE_HEX
 						      : AT_SOCKET_MODE_UNFORMATTED,
-			      sizeof(sm_data_buf));
+			      recv_max_get(sock), true);
 	} else {
 		err = do_recvfrom(sock, 0, MSG_DONTWAIT,
 				  sock->async_poll.adr_hex ? AT_SOCKET_MODE_HEX
 							  : AT_SOCKET_MODE_UNFORMATTED,
-				  sizeof(sm_data_buf));
+				  recv_max_get(sock), true);
 	}
 	if (err) {
 		LOG_ERR("auto_reception() error: %d", err);
-		sm_at_host_unlock(sock->pipe);
-		return;
-	}
-	if (!in_datamode(sock->pipe)) {
-		/* <CR><LF> after the data. */
-		rsp_send_to(sock->pipe, "\r\n");
 	}
 	sm_at_host_unlock(sock->pipe);
 }
@@ -315,10 +355,34 @@ void sm_at_socket_poll_idle_handler(struct k_work *work)
 	sm_at_socket_poll_work_handler(&poll_ctx->poll_work);
 }
 
+/* #XAPOLL URCs of a poll work run, sent together. */
+#define XAPOLL_URC_MAX_LEN sizeof("\r\n#XAPOLL: -2147483648,255\r\n")
+
+struct xapoll_urcs {
+	char buf[SM_MAX_SOCKET_COUNT * XAPOLL_URC_MAX_LEN];
+	size_t len;
+};
+
+static void xapoll_urcs_flush(struct modem_pipe *pipe, struct xapoll_urcs *urcs)
+{
+	if (urcs->len > 0) {
+		urc_send_to(pipe, "%s", urcs->buf);
+		urcs->len = 0;
+	}
+}
+
+static void xapoll_urcs_add(struct xapoll_urcs *urcs, int fd, uint8_t events)
+{
+	urcs->len += snprintf(urcs->buf + urcs->len, sizeof(urcs->buf) - urcs->len,
+			      "\r\n#XAPOLL: %d,%d\r\n", fd, events);
+}
+
 void sm_at_socket_poll_work_handler(struct k_work *work)
 {
 	struct async_poll_ctx *poll_ctx = CONTAINER_OF(work, struct async_poll_ctx, poll_work);
 	struct modem_pipe *pipe = sm_at_host_get_pipe_from_poll_ctx(poll_ctx);
+	struct xapoll_urcs urcs = {.len = 0};
+	atomic_val_t pending;
 
 	if (!pipe || !poll_ctx) {
 		LOG_ERR("No pipe or poll context found for poll work handler");
@@ -328,9 +392,20 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 	bool at_and_idle = is_idle(pipe);
 	bool data_mode = in_datamode(pipe);
 
-	for (int i = 0; i < SM_MAX_SOCKET_COUNT; i++) {
+	/* Visit only the sockets that have received poll events, or that have delayed events
+	 * to re-enable when back in AT mode.
+	 */
+	pending = atomic_clear(&poll_ctx->ready);
+	if (at_and_idle) {
+		pending |= atomic_clear(&poll_ctx->delayed);
+	}
+
+	for (int i = 0; pending != 0; i++, pending >>= 1) {
 		struct sm_socket *sock = &socks[i];
 
+		if ((pending & 1) == 0) {
+			continue;
+		}
 		if (sock->fd == INVALID_SOCKET || sock->pipe != pipe) {
 			continue;
 		}
@@ -344,6 +419,9 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 			sock->async_poll.delayed_revents |= revents;
 			LOG_DBG("Socket %d delayed revents 0x%x", sock->fd,
 				sock->async_poll.delayed_revents);
+			if (sock->async_poll.delayed_revents) {
+				atomic_set_bit(&poll_ctx->delayed, i);
+			}
 			sm_at_host_queue_idle_work(pipe, &poll_ctx->idle_work);
 		}
 
@@ -368,6 +446,13 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 
 		assert(at_and_idle || (data_mode && sock == poll_ctx->datamode_sock));
 
+		/* Remove POLLOUT from poll, until send is done. Done before notifying the
+		 * HTTP client, so that it can re-arm POLLOUT to continue sending.
+		 */
+		if (revents & ZSOCK_POLLOUT) {
+			sock->async_poll.events &= ~ZSOCK_POLLOUT;
+		}
+
 		/* Send #XAPOLL URC for poll events. */
 		if (!data_mode) {
 			uint8_t xapoll_events = revents & (sock->async_poll.xapoll_events);
@@ -376,11 +461,16 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 			/* Do not send URC for the same events twice, unless send/recv is done. */
 			sock->async_poll.xapoll_events &= ~xapoll_events;
 			if (xapoll_events) {
-				urc_send_to(pipe, "\r\n#XAPOLL: %d,%d\r\n", sock->fd,
-					    xapoll_events);
-				/* Notify HTTP client if it's using this socket */
+				xapoll_urcs_add(&urcs, sock->fd, xapoll_events);
+				/* Notify HTTP client if it's using this socket. Its URCs must
+				 * follow the #XAPOLL URCs, so these are sent first.
+				 */
 #if defined(CONFIG_SM_HTTPC)
-				http_needs_rearm = sm_at_httpc_poll_event(sock->fd, xapoll_events);
+				if (sm_at_httpc_owns(sock->fd)) {
+					xapoll_urcs_flush(pipe, &urcs);
+					http_needs_rearm =
+						sm_at_httpc_poll_event(sock->fd, xapoll_events);
+				}
 #endif
 			}
 
@@ -395,11 +485,6 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 			}
 		}
 
-		/* Remove POLLOUT from poll, until send is done. */
-		if (revents & ZSOCK_POLLOUT) {
-			sock->async_poll.events &= ~ZSOCK_POLLOUT;
-		}
-
 		/* Prevent further poll activations for socket. */
 		if (revents & (ZSOCK_POLLERR | ZSOCK_POLLNVAL | ZSOCK_POLLHUP)) {
 			sock->async_poll.disable = true;
@@ -412,6 +497,8 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 			/* Automatic data reception may reactivate POLLIN. */
 			if (((at_and_idle && (sock->async_poll.adr_flags & SM_ADR_AT_MODE)) ||
 			     (data_mode && (sock->async_poll.adr_flags & SM_ADR_DATA_MODE)))) {
+				/* URCs of the events first, then the data. */
+				xapoll_urcs_flush(pipe, &urcs);
 				auto_reception(sock);
 			}
 		}
@@ -439,6 +526,8 @@ void sm_at_socket_poll_work_handler(struct k_work *work)
 			}
 		}
 	}
+
+	xapoll_urcs_flush(pipe, &urcs);
 }
 
 static void send_cb_fn(struct k_work *work)
@@ -580,7 +669,7 @@ static int do_socket_open(struct sm_socket *sock)
 		return -errno;
 	}
 
-	sock->fd = ret;
+	set_socket_fd(sock, ret);
 	struct timeval tmo = {.tv_sec = SOCKET_SEND_TMO_SEC};
 
 	ret = zsock_setsockopt(sock->fd, SOL_SOCKET, SO_SNDTIMEO, &tmo, sizeof(tmo));
@@ -608,6 +697,7 @@ static int do_socket_open(struct sm_socket *sock)
 	sock->async_poll.adr_flags = poll_ctx->adr_flags;
 	sock->async_poll.adr_hex = poll_ctx->adr_hex;
 	sock->async_poll.xapoll_events_requested = poll_ctx->xapoll_events_requested;
+	sock->recv_max = poll_ctx->recv_max;
 	update_poll_events(
 		sock, ZSOCK_POLLIN | ZSOCK_POLLOUT | ZSOCK_POLLERR | ZSOCK_POLLHUP | ZSOCK_POLLNVAL,
 		true);
@@ -616,7 +706,7 @@ static int do_socket_open(struct sm_socket *sock)
 
 error:
 	zsock_close(sock->fd);
-	sock->fd = INVALID_SOCKET;
+	set_socket_fd(sock, INVALID_SOCKET);
 	return ret;
 }
 
@@ -640,7 +730,7 @@ static int do_secure_socket_open(struct sm_socket *sock, int peer_verify)
 		LOG_ERR("zsock_socket() error: %d", -errno);
 		return -errno;
 	}
-	sock->fd = ret;
+	set_socket_fd(sock, ret);
 
 	struct timeval tmo = {.tv_sec = SOCKET_SEND_TMO_SEC};
 
@@ -687,6 +777,7 @@ static int do_secure_socket_open(struct sm_socket *sock, int peer_verify)
 	sock->async_poll.adr_flags = poll_ctx->adr_flags;
 	sock->async_poll.adr_hex = poll_ctx->adr_hex;
 	sock->async_poll.xapoll_events_requested = poll_ctx->xapoll_events_requested;
+	sock->recv_max = poll_ctx->recv_max;
 	update_poll_events(
 		sock, ZSOCK_POLLIN | ZSOCK_POLLOUT | ZSOCK_POLLERR | ZSOCK_POLLHUP | ZSOCK_POLLNVAL,
 		true);
@@ -695,7 +786,7 @@ static int do_secure_socket_open(struct sm_socket *sock, int peer_verify)
 
 error:
 	zsock_close(sock->fd);
-	sock->fd = INVALID_SOCKET;
+	set_socket_fd(sock, INVALID_SOCKET);
 	return ret;
 }
 
@@ -1092,32 +1183,41 @@ static int do_send(struct sm_socket *sock, const uint8_t *data, int len, int fla
 	return sent > 0 ? sent : ret;
 }
 
-static int data_send_hex(struct sm_socket *sock, const uint8_t *buf, int recv_len)
+/* Send received data, preceded by the response header and optionally followed by <CR><LF>.
+ * The header and <CR><LF> are sent only in AT mode.
+ */
+static int recv_data_send(struct sm_socket *sock, const char *hdr, enum sm_socket_mode mode,
+			  const uint8_t *buf, int len, bool crlf)
 {
-	size_t consumed = 0;
-	char hex_buf[257] = {0};
-	uint16_t data_len =
-		recv_len < (sizeof(hex_buf) - 1) / 2 ? recv_len : (sizeof(hex_buf) - 1) / 2;
-
-	/* For hex string mode, convert the received data to hex string */
-	while (consumed < recv_len) {
-		size_t size = bin2hex(buf + consumed, data_len, hex_buf, sizeof(hex_buf));
+	if (in_datamode(sock->pipe)) {
+		hdr = NULL;
+		crlf = false;
+	}
 
-		if (size == 0) {
-			LOG_ERR("Failed to convert binary data to hex string");
-			return -EINVAL;
+	if (mode == AT_SOCKET_MODE_HEX) {
+		if (hdr) {
+			rsp_send_to(sock->pipe, "%s", hdr);
 		}
-		data_send(sock->pipe, hex_buf, size);
-		consumed += size / 2; /* size is in hex string length */
-		if (recv_len - consumed < data_len) {
-			data_len = recv_len - consumed;
+		data_send_hex(sock->pipe, buf, len);
+		if (crlf) {
+			rsp_send_to(sock->pipe, "\r\n");
 		}
+		return 0;
 	}
+
+	const struct sm_iovec iov[] = {
+		{ .base = hdr, .len = hdr ? strlen(hdr) : 0 },
+		{ .base = buf, .len = len },
+		{ .base = CRLF_STR, .len = crlf ? strlen(CRLF_STR) : 0 },
+	};
+
+	data_sendv(sock->pipe, iov, ARRAY_SIZE(iov));
+
 	return 0;
 }
 
-static int do_recv(struct sm_socket *sock, int timeout, int flags,
-		   enum sm_socket_mode mode, size_t data_len)
+static int recv_into(struct sm_socket *sock, uint8_t *buf, int timeout, int flags,
+		     enum sm_socket_mode mode, size_t data_len, bool crlf)
 {
 	int ret;
 	int sockfd = sock->fd;
@@ -1128,7 +1228,7 @@ static int do_recv(struct sm_socket *sock, int timeout, int flags,
 		LOG_ERR("zsock_setsockopt(%d) error: %d", SO_RCVTIMEO, -errno);
 		return -errno;
 	}
-	ret = zsock_recv(sockfd, (void *)sm_data_buf, data_len, flags);
+	ret = zsock_recv(sockfd, (void *)buf, data_len, flags);
 	if (ret < 0) {
 		LOG_WRN("zsock_recv() error: %d", -errno);
 		return -errno;
@@ -1142,23 +1242,20 @@ static int do_recv(struct sm_socket *sock, int timeout, int flags,
 	 */
 	if (ret == 0) {
 		LOG_WRN("zsock_recv() return 0");
-	} else {
-		sm_at_host_lock(sock->pipe);
-		if (!in_datamode(sock->pipe)) {
-			rsp_send_to(sock->pipe, "\r\n#XRECV: %d,%d,%d\r\n", sock->fd, mode, ret);
+		if (crlf && !in_datamode(sock->pipe)) {
+			rsp_send_to(sock->pipe, "\r\n");
 		}
+	} else {
+		char hdr[sizeof("\r\n#XRECV: ,,\r\n") + 3 * 11];
 
-		if (mode == AT_SOCKET_MODE_HEX) {
-			ret = data_send_hex(sock, sm_data_buf, ret);
-			if (ret) {
-				sm_at_host_unlock(sock->pipe);
-				return ret;
-			}
-		} else {
-			data_send(sock->pipe, sm_data_buf, ret);
-		}
-		ret = 0;
+		snprintf(hdr, sizeof(hdr), "\r\n#XRECV: %d,%d,%d\r\n", sock->fd, mode, ret);
+
+		sm_at_host_lock(sock->pipe);
+		ret = recv_data_send(sock, hdr, mode, buf, ret, crlf);
 		sm_at_host_unlock(sock->pipe);
+		if (ret) {
+			return ret;
+		}
 
 		update_poll_events(sock, ZSOCK_POLLIN, true);
 	}
@@ -1166,20 +1263,13 @@ static int do_recv(struct sm_socket *sock, int timeout, int flags,
 	return ret;
 }
 
-static int do_sendto(struct sm_socket *sock, const char *url, uint16_t port, const uint8_t *data,
-		     int len, int flags)
+static int do_sendto_addr(struct sm_socket *sock, const struct net_sockaddr *sa,
+			  const uint8_t *data, int len, int flags)
 {
 	int ret = 0;
 	uint32_t sent = 0;
-	struct net_sockaddr sa = {.sa_family = NET_AF_UNSPEC};
 	bool send_ntf = (flags & SM_MSG_SEND_ACK) != 0;
 
-	LOG_DBG("sendto %s:%d, flags=%d", url, port, flags);
-	ret = util_resolve_host(sock->cid, url, port, sock->family, &sa);
-	if (ret) {
-		return -EAGAIN;
-	}
-
 	if (send_ntf) {
 		/* Set send callback. */
 		flags &= ~SM_MSG_SEND_ACK;
@@ -1196,9 +1286,9 @@ static int do_sendto(struct sm_socket *sock, const char *url, uint16_t port, con
 	}
 
 	do {
-		ret = zsock_sendto(sock->fd, data + sent, len - sent, flags, &sa,
-				   sa.sa_family == AF_INET ? sizeof(struct sockaddr_in)
-							   : sizeof(struct sockaddr_in6));
+		ret = zsock_sendto(sock->fd, data + sent, len - sent, flags, sa,
+				   sa->sa_family == AF_INET ? sizeof(struct sockaddr_in)
+							    : sizeof(struct sockaddr_in6));
 		if (ret <= 0) {
 			ret = -errno;
 			break;
@@ -1230,8 +1320,23 @@ static int do_sendto(struct sm_socket *sock, const char *url, uint16_t port, con
 	return sent > 0 ? sent : ret;
 }
 
-static int do_recvfrom(struct sm_socket *sock, int timeout, int flags,
-		       enum sm_socket_mode mode, size_t data_len)
+static int do_sendto(struct sm_socket *sock, const char *url, uint16_t port, const uint8_t *data,
+		     int len, int flags)
+{
+	int ret;
+	struct net_sockaddr sa = {.sa_family = NET_AF_UNSPEC};
+
+	LOG_DBG("sendto %s:%d, flags=%d", url, port, flags);
+	ret = util_resolve_host(sock->cid, url, port, sock->family, &sa);
+	if (ret) {
+		return -EAGAIN;
+	}
+
+	return do_sendto_addr(sock, &sa, data, len, flags);
+}
+
+static int recvfrom_into(struct sm_socket *sock, uint8_t *buf, int timeout, int flags,
+			 enum sm_socket_mode mode, size_t data_len, bool crlf)
 {
 	int ret;
 	struct net_sockaddr remote;
@@ -1243,7 +1348,7 @@ static int do_recvfrom(struct sm_socket *sock, int timeout, int flags,
 		LOG_ERR("zsock_setsockopt(%d) error: %d", SO_RCVTIMEO, -errno);
 		return -errno;
 	}
-	ret = zsock_recvfrom(sock->fd, (void *)sm_data_buf, data_len, flags,
+	ret = zsock_recvfrom(sock->fd, (void *)buf, data_len, flags,
 			   (struct sockaddr *)&remote, &addrlen);
 	if (ret < 0) {
 		LOG_ERR("zsock_recvfrom() error: %d", -errno);
@@ -1256,27 +1361,24 @@ static int do_recvfrom(struct sm_socket *sock, int timeout, int flags,
 	 */
 	if (ret == 0) {
 		LOG_WRN("zsock_recvfrom() return 0");
+		if (crlf && !in_datamode(sock->pipe)) {
+			rsp_send_to(sock->pipe, "\r\n");
+		}
 	} else {
-		sm_at_host_lock(sock->pipe);
-		if (!in_datamode(sock->pipe)) {
-			char peer_addr[INET6_ADDRSTRLEN] = {0};
-			uint16_t peer_port = 0;
+		char peer_addr[INET6_ADDRSTRLEN] = {0};
+		char hdr[sizeof("\r\n#XRECVFROM: ,,,\"\",\r\n") + 4 * 11 + INET6_ADDRSTRLEN];
+		uint16_t peer_port = 0;
 
-			util_get_peer_addr((struct net_sockaddr *)&remote, peer_addr, &peer_port);
-			rsp_send_to(sock->pipe, "\r\n#XRECVFROM: %d,%d,%d,\"%s\",%d\r\n", sock->fd,
-				    mode, ret, peer_addr, peer_port);
-		}
+		util_get_peer_addr((struct net_sockaddr *)&remote, peer_addr, &peer_port);
+		snprintf(hdr, sizeof(hdr), "\r\n#XRECVFROM: %d,%d,%d,\"%s\",%d\r\n", sock->fd,
+			 mode, ret, peer_addr, peer_port);
 
-		if (mode == AT_SOCKET_MODE_HEX) {
-			ret = data_send_hex(sock, sm_data_buf, ret);
-			if (ret) {
-				sm_at_host_unlock(sock->pipe);
-				return ret;
-			}
-		} else {
-			data_send(sock->pipe, sm_data_buf, ret);
-		}
+		sm_at_host_lock(sock->pipe);
+		ret = recv_data_send(sock, hdr, mode, buf, ret, crlf);
 		sm_at_host_unlock(sock->pipe);
+		if (ret) {
+			return ret;
+		}
 
 		update_poll_events(sock, ZSOCK_POLLIN, true);
 	}
@@ -1284,6 +1386,48 @@ static int do_recvfrom(struct sm_socket *sock, int timeout, int flags,
 	return 0;
 }
 
+static uint8_t *recv_buf_lease(void)
+{
+	uint8_t *buf;
+
+	if (k_mem_slab_alloc(&recv_buf_slab, (void **)&buf, RECV_BUF_LEASE_TMO)) {
+		LOG_ERR("No receive buffer available");
+		return NULL;
+	}
+
+	return buf;
+}
+
+static int do_recv(struct sm_socket *sock, int timeout, int flags,
+		   enum sm_socket_mode mode, size_t data_len, bool crlf)
+{
+	uint8_t *buf = recv_buf_lease();
+	int ret;
+
+	if (buf == NULL) {
+		return -ENOBUFS;
+	}
+	ret = recv_into(sock, buf, timeout, flags, mode, data_len, crlf);
+	k_mem_slab_free(&recv_buf_slab, buf);
+
+	return ret;
+}
+
+static int do_recvfrom(struct sm_socket *sock, int timeout, int flags,
+		       enum sm_socket_mode mode, size_t data_len, bool crlf)
+{
+	uint8_t *buf = recv_buf_lease();
+	int ret;
+
+	if (buf == NULL) {
+		return -ENOBUFS;
+	}
+	ret = recvfrom_into(sock, buf, timeout, flags, mode, data_len, crlf);
+	k_mem_slab_free(&recv_buf_slab, buf);
+
+	return ret;
+}
+
 static int socket_datamode_callback(uint8_t op, const uint8_t *data, int len, uint8_t flags)
 {
 	int ret = 0;
@@ -1298,8 +1442,8 @@ static int socket_datamode_callback(uint8_t op, const uint8_t *data, int len, ui
 			return -EOVERFLOW;
 		}
 		if (strlen(udp_url) > 0) {
-			ret = do_sendto(poll_ctx->datamode_sock, udp_url, udp_port, data, len,
-					poll_ctx->datamode_sock->send_flags);
+			ret = do_sendto_addr(poll_ctx->datamode_sock, &udp_peer, data, len,
+					     poll_ctx->datamode_sock->send_flags);
 		} else {
 			ret = do_send(poll_ctx->datamode_sock, data, len,
 				      poll_ctx->datamode_sock->send_flags);
@@ -1780,7 +1924,7 @@ STATIC int handle_at_send(enum at_parser_cmd_type cmd_type, struct at_parser *pa
 
 			/* Convert hex string to binary data */
 			if (mode == AT_SOCKET_MODE_HEX) {
-				size = hex2bin(str_ptr, size, bin_data, sizeof(bin_data));
+				size = util_hex2bin(str_ptr, size, bin_data, sizeof(bin_data));
 				if (size == 0) {
 					LOG_ERR("Failed to convert hex string to binary data");
 					return -EINVAL;
@@ -1804,7 +1948,11 @@ STATIC int handle_at_send(enum at_parser_cmd_type cmd_type, struct at_parser *pa
 			struct async_poll_ctx *poll_ctx = sm_at_host_get_async_poll_ctx(sock->pipe);
 
 			poll_ctx->datamode_sock = sock;
-			err = enter_datamode(socket_datamode_callback, data_len);
+			if (sock->type == SOCK_STREAM) {
+				err = enter_datamode_stream(socket_datamode_callback, data_len);
+			} else {
+				err = enter_datamode(socket_datamode_callback, data_len);
+			}
 			if (!err && sock->async_poll.adr_flags & SM_ADR_DATA_MODE) {
 				update_poll_events(sock, ZSOCK_POLLIN, false);
 			}
@@ -1829,7 +1977,7 @@ STATIC int handle_at_recv(enum at_parser_cmd_type cmd_type, struct at_parser *pa
 	uint16_t mode;
 	int timeout;
 	int flags = 0;
-	int data_len = sizeof(sm_data_buf);
+	int data_len;
 	struct sm_socket *sock = NULL;
 
 	switch (cmd_type) {
@@ -1857,18 +2005,19 @@ STATIC int handle_at_recv(enum at_parser_cmd_type cmd_type, struct at_parser *pa
 		if (err) {
 			return err;
 		}
+		data_len = recv_max_get(sock);
 		if (param_count > 5) {
 			err = at_parser_num_get(parser, 5, &data_len);
 			if (err) {
 				return err;
 			}
-			if (data_len > sizeof(sm_data_buf)) {
+			if (data_len > CONFIG_SM_SOCKET_RX_MAX_SIZE) {
 				LOG_ERR("data_len is too large for receive buffer");
 				return -ENOBUFS;
 			}
 		}
 		sock->pipe = sm_at_host_get_current_pipe();
-		err = do_recv(sock, timeout, flags, mode, data_len);
+		err = do_recv(sock, timeout, flags, mode, data_len, false);
 		break;
 
 	default:
@@ -1931,7 +2080,7 @@ STATIC int handle_at_sendto(enum at_parser_cmd_type cmd_type, struct at_parser *
 
 			/* Convert hex string to binary data */
 			if (mode == AT_SOCKET_MODE_HEX) {
-				size = hex2bin(str_ptr, size, bin_data, sizeof(bin_data));
+				size = util_hex2bin(str_ptr, size, bin_data, sizeof(bin_data));
 				if (size == 0) {
 					LOG_ERR("Failed to convert hex string to binary data");
 					return -EINVAL;
@@ -1954,6 +2103,13 @@ STATIC int handle_at_sendto(enum at_parser_cmd_type cmd_type, struct at_parser *
 					return err;
 				}
 			}
+			/* Resolve the peer once, not for every datagram. */
+			err = util_resolve_host(sock->cid, udp_url, udp_port, sock->family,
+						&udp_peer);
+			if (err) {
+				memset(udp_url, 0, sizeof(udp_url));
+				return -EAGAIN;
+			}
 			struct async_poll_ctx *poll_ctx = sm_at_host_get_async_poll_ctx(sock->pipe);
 
 			poll_ctx->datamode_sock = sock;
@@ -1982,7 +2138,7 @@ STATIC int handle_at_recvfrom(enum at_parser_cmd_type cmd_type, struct at_parser
 	uint16_t mode;
 	int timeout;
 	int flags = 0;
-	int data_len = sizeof(sm_data_buf);
+	int data_len;
 	struct sm_socket *sock = NULL;
 
 	switch (cmd_type) {
@@ -2010,18 +2166,19 @@ STATIC int handle_at_recvfrom(enum at_parser_cmd_type cmd_type, struct at_parser
 		if (err) {
 			return err;
 		}
+		data_len = recv_max_get(sock);
 		if (param_count > 5) {
 			err = at_parser_num_get(parser, 5, &data_len);
 			if (err) {
 				return err;
 			}
-			if (data_len > sizeof(sm_data_buf)) {
+			if (data_len > CONFIG_SM_SOCKET_RX_MAX_SIZE) {
 				LOG_ERR("data_len is too large for receive buffer");
 				return -ENOBUFS;
 			}
 		}
 		sock->pipe = sm_at_host_get_current_pipe();
-		err = do_recvfrom(sock, timeout, flags, mode, data_len);
+		err = do_recvfrom(sock, timeout, flags, mode, data_len, false);
 		break;
 
 	default:
@@ -2128,7 +2285,7 @@ static int do_accept(struct sm_socket *sock)
 		return -EINVAL;
 	}
 	init_socket(new_sock);
-	new_sock->fd = ret;
+	set_socket_fd(new_sock, ret);
 	new_sock->family = remote.sa_family;
 	new_sock->type = SOCK_STREAM;
 	new_sock->role = AT_SOCKET_ROLE_CLIENT;
@@ -2143,6 +2300,7 @@ static int do_accept(struct sm_socket *sock)
 	new_sock->async_poll.adr_flags = poll_ctx->adr_flags;
 	new_sock->async_poll.adr_hex = poll_ctx->adr_hex;
 	new_sock->async_poll.xapoll_events_requested = poll_ctx->xapoll_events_requested;
+	new_sock->recv_max = poll_ctx->recv_max;
 	update_poll_events(new_sock,
 			   ZSOCK_POLLIN | ZSOCK_POLLOUT | ZSOCK_POLLERR | ZSOCK_POLLHUP |
 				   ZSOCK_POLLNVAL,
@@ -2303,6 +2461,12 @@ static void xapoll_read_response(void)
 	}
 }
 
+/* Exported for HTTP client use */
+int get_socket_sec_tag(struct sm_socket *sock)
+{
+	return sock->sec_tag;
+}
+
 /* Exported for HTTP client use */
 int set_xapoll_events(struct sm_socket *sock, uint8_t events)
 {
@@ -2411,6 +2575,7 @@ STATIC int handle_at_recvcfg(enum at_parser_cmd_type cmd_type, struct at_parser
 	int fd = -1;
 	uint16_t flags;
 	uint16_t hex_mode = 0;
+	uint16_t recv_max = 0;
 	struct sm_socket *sock = NULL;
 	struct modem_pipe *pipe = sm_at_host_get_current_pipe();
 	struct async_poll_ctx *poll_ctx = sm_at_host_get_async_poll_ctx(pipe);
@@ -2438,6 +2603,12 @@ STATIC int handle_at_recvcfg(enum at_parser_cmd_type cmd_type, struct at_parser
 				return -EINVAL;
 			}
 		}
+		if (param_count > 4) {
+			err = at_parser_num_get(parser, 4, &recv_max);
+			if (err || recv_max > CONFIG_SM_SOCKET_RX_MAX_SIZE) {
+				return -EINVAL;
+			}
+		}
 		if ((flags & SM_ADR_DATA_MODE) && hex_mode) {
 			LOG_ERR("Hex mode with data mode is not supported.");
 			return -EINVAL;
@@ -2446,15 +2617,18 @@ STATIC int handle_at_recvcfg(enum at_parser_cmd_type cmd_type, struct at_parser
 			sock->pipe = pipe;
 			sock->async_poll.adr_flags = flags;
 			sock->async_poll.adr_hex = hex_mode != 0;
+			sock->recv_max = recv_max;
 			err = update_poll_events(sock, ZSOCK_POLLIN, false);
 		} else {
 			/* Apply to all sockets in this context */
 			poll_ctx->adr_flags = flags;
 			poll_ctx->adr_hex = hex_mode != 0;
+			poll_ctx->recv_max = recv_max;
 			for (int i = 0; i < SM_MAX_SOCKET_COUNT; i++) {
 				if (socks[i].fd != INVALID_SOCKET && socks[i].pipe == pipe) {
 					socks[i].async_poll.adr_flags = poll_ctx->adr_flags;
 					socks[i].async_poll.adr_hex = poll_ctx->adr_hex;
+					socks[i].recv_max = poll_ctx->recv_max;
 					err = update_poll_events(&socks[i], ZSOCK_POLLIN, false);
 					if (err) {
 						return err;
@@ -2468,18 +2642,18 @@ STATIC int handle_at_recvcfg(enum at_parser_cmd_type cmd_type, struct at_parser
 		for (int i = 0; i < SM_MAX_SOCKET_COUNT; i++) {
 			if (socks[i].fd != INVALID_SOCKET && socks[i].pipe == pipe &&
 			    socks[i].async_poll.adr_flags) {
-				rsp_send("\r\n#XRECVCFG: %d,%d,%d\r\n", socks[i].fd,
+				rsp_send("\r\n#XRECVCFG: %d,%d,%d,%d\r\n", socks[i].fd,
 					 socks[i].async_poll.adr_flags,
-					 socks[i].async_poll.adr_hex);
+					 socks[i].async_poll.adr_hex, recv_max_get(&socks[i]));
 			}
 		}
 		err = 0;
 		break;
 
 	case AT_PARSER_CMD_TYPE_TEST:
-		rsp_send("\r\n#XRECVCFG: <handle>,(%d,%d,%d,%d),(%d,%d)\r\n", SM_ADR_DISABLE,
+		rsp_send("\r\n#XRECVCFG: <handle>,(%d,%d,%d,%d),(%d,%d),(0-%d)\r\n", SM_ADR_DISABLE,
 			 SM_ADR_AT_MODE, SM_ADR_DATA_MODE, SM_ADR_AT_MODE | SM_ADR_DATA_MODE,
-			 AT_SOCKET_MODE_UNFORMATTED, AT_SOCKET_MODE_HEX);
+			 AT_SOCKET_MODE_UNFORMATTED, AT_SOCKET_MODE_HEX, CONFIG_SM_SOCKET_RX_MAX_SIZE);
 		err = 0;
 		break;
 
@@ -28,7 +28,10 @@ struct async_poll_ctx {
 	uint8_t xapoll_events_requested; /**< Events requested for all the sockets for async poll */
 	uint8_t adr_flags;               /**< Auto reception flags for all sockets. */
 	bool adr_hex: 1;                 /**< Auto reception hex mode for all sockets. */
+	uint16_t recv_max;               /**< Maximum read size for all sockets, 0 for default. */
 	struct sm_socket *datamode_sock; /**< Socket for data mode */
+	atomic_t ready;                  /**< Socket slots with poll events to process. */
+	atomic_t delayed;                /**< Socket slots with delayed poll events. */
 };
 
 /**
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SM_CGEV_
+#define SM_CGEV_
+
+/** @file sm_cgev.h
+ *
+ * @brief Subscription to the +CGEV notifications of the modem
+ * @{
+ */
+#include <stdbool.h>
+
+/* Whether to forward CGEV notifications to the Serial Modem UART. */
+extern bool sm_fwd_cgev_notifs;
+
+/** @} */
+
+#endif /* SM_CGEV_ */
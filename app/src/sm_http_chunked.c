@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sm_http_chunked.h"
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+/* Largest chunk size accepted, so that the size cannot overflow while it is parsed. */
+#define CHUNK_SIZE_MAX (UINT32_MAX >> 4)
+
+enum chunked_state {
+	CHUNKED_SIZE_START,   /* First digit of a chunk size */
+	CHUNKED_SIZE,         /* Further digits of a chunk size */
+	CHUNKED_EXT,          /* Chunk extensions, until the end of the line */
+	CHUNKED_SIZE_LF,      /* LF after the chunk size line */
+	CHUNKED_DATA,         /* Chunk data */
+	CHUNKED_DATA_CR,      /* CR after chunk data */
+	CHUNKED_DATA_LF,      /* LF after chunk data */
+	CHUNKED_TRAILER,      /* Start of a trailer field line or of the final line */
+	CHUNKED_TRAILER_LINE, /* Trailer field, until the end of the line */
+	CHUNKED_TRAILER_LF,   /* LF after a trailer field line */
+	CHUNKED_END_LF,       /* LF of the final line */
+	CHUNKED_DONE,         /* End of the message body */
+};
+
+static int hex_value(uint8_t c)
+{
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+
+	return -1;
+}
+
+void sm_http_chunked_init(struct sm_http_chunked *dec)
+{
+	dec->state = CHUNKED_SIZE_START;
+	dec->remaining = 0;
+}
+
+int sm_http_chunked_decode(struct sm_http_chunked *dec, uint8_t *buf, size_t len,
+			   size_t *consumed)
+{
+	size_t in = 0;
+	size_t out = 0;
+
+	while (in < len && dec->state != CHUNKED_DONE) {
+		uint8_t c = buf[in];
+		int digit;
+
+		switch (dec->state) {
+		case CHUNKED_SIZE_START:
+		case CHUNKED_SIZE:
+			digit = hex_value(c);
+			if (digit >= 0) {
+				if (dec->remaining > CHUNK_SIZE_MAX) {
+					return -EBADMSG;
+				}
+				dec->remaining = (dec->remaining << 4) | digit;
+				dec->state = CHUNKED_SIZE;
+			} else if (dec->state == CHUNKED_SIZE_START) {
+				return -EBADMSG;
+			} else if (c == '\r') {
+				dec->state = CHUNKED_SIZE_LF;
+			} else if (c == ';' || c == ' ' || c == '\t') {
+				dec->state = CHUNKED_EXT;
+			} else {
+				return -EBADMSG;
+			}
+			in++;
+			break;
+
+		case CHUNKED_EXT:
+			if (c == '\r') {
+				dec->state = CHUNKED_SIZE_LF;
+			}
+			in++;
+			break;
+
+		case CHUNKED_SIZE_LF:
+			if (c != '\n') {
+				return -EBADMSG;
+			}
+			dec->state = dec->remaining ? CHUNKED_DATA : CHUNKED_TRAILER;
+			in++;
+			break;
+
+		case CHUNKED_DATA: {
+			size_t n = MIN(dec->remaining, len - in);
+
+			memmove(buf + out, buf + in, n);
+			in += n;
+			out += n;
+			dec->remaining -= n;
+			if (dec->remaining == 0) {
+				dec->state = CHUNKED_DATA_CR;
+			}
+			break;
+		}
+
+		case CHUNKED_DATA_CR:
+			if (c != '\r') {
+				return -EBADMSG;
+			}
+			dec->state = CHUNKED_DATA_LF;
+			in++;
+			break;
+
+		case CHUNKED_DATA_LF:
+			if (c != '\n') {
+				return -EBADMSG;
+			}
+			dec->state = CHUNKED_SIZE_START;
+			in++;
+			break;
+
+		case CHUNKED_TRAILER:
+			dec->state = c == '\r' ? CHUNKED_END_LF : CHUNKED_TRAILER_LINE;
+			in++;
+			break;
+
+		case CHUNKED_TRAILER_LINE:
+			if (c == '\r') {
+				dec->state = CHUNKED_TRAILER_LF;
+			}
+			in++;
+			break;
+
+		case CHUNKED_TRAILER_LF:
+			if (c != '\n') {
+				return -EBADMSG;
+			}
+			dec->state = CHUNKED_TRAILER;
+			in++;
+			break;
+
+		case CHUNKED_END_LF:
+			if (c != '\n') {
+				return -EBADMSG;
+			}
+			dec->state = CHUNKED_DONE;
+			in++;
+			break;
+
+		default:
+			return -EBADMSG;
+		}
+	}
+
+	*consumed = in;
+
+	return out;
+}
+
+bool sm_http_chunked_done(const struct sm_http_chunked *dec)
+{
+	return dec->state == CHUNKED_DONE;
+}
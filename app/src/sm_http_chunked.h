@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SM_HTTP_CHUNKED_
+#define SM_HTTP_CHUNKED_
+
+/** @file sm_http_chunked.h
+ *
+ * @brief Decoder for the chunked transfer coding of HTTP/1.1 (RFC 9112 §7.1)
+ * @{
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief State of a chunked transfer coding decoder.
+ *
+ * The state is kept between calls, so the framing can be split over any number of reads.
+ */
+struct sm_http_chunked {
+	uint8_t state;
+	/* Chunk size being parsed, or data bytes left in the current chunk. */
+	uint32_t remaining;
+};
+
+/**
+ * @brief Initialize a decoder for a new message body.
+ *
+ * @param dec Decoder.
+ */
+void sm_http_chunked_init(struct sm_http_chunked *dec);
+
+/**
+ * @brief Decode a part of a chunked message body in place.
+ *
+ * Chunk size lines, chunk extensions, the line breaks after chunk data and the trailer section
+ * are removed, and the chunk data is moved to the start of the buffer.
+ * Decoding stops at the end of the message body, so the bytes after it are left for the caller.
+ *
+ * @param dec Decoder.
+ * @param buf Received bytes, replaced with the decoded body bytes.
+ * @param len Amount of received bytes.
+ * @param consumed Amount of received bytes that belong to the message body. Less than @p len
+ *                 only when the end of the message body is reached.
+ *
+ * @retval Amount of decoded body bytes at the start of @p buf. -EBADMSG on invalid framing.
+ */
+int sm_http_chunked_decode(struct sm_http_chunked *dec, uint8_t *buf, size_t len,
+			   size_t *consumed);
+
+/**
+ * @brief Check whether the end of the message body has been decoded.
+ *
+ * @param dec Decoder.
+ *
+ * @retval true if the last chunk and the trailer section have been decoded.
+ */
+bool sm_http_chunked_done(const struct sm_http_chunked *dec);
+
+/** @} */
+
+#endif /* SM_HTTP_CHUNKED_ */
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sm_http_header.h"
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <strings.h>
+
+#define STRLIT_LEN(s) (sizeof(s) - 1)
+
+/* Check whether a string of the given length is equal to a token, ignoring case. */
+static bool token_equal(const char *s, size_t len, const char *token)
+{
+	return len == strlen(token) && strncasecmp(s, token, len) == 0;
+}
+
+static bool is_ows(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+/* Remove the optional whitespace around a string. */
+static void trim_ows(const char **s, size_t *len)
+{
+	while (*len > 0 && is_ows(**s)) {
+		(*s)++;
+		(*len)--;
+	}
+	while (*len > 0 && is_ows((*s)[*len - 1])) {
+		(*len)--;
+	}
+}
+
+/* Parse a non-negative decimal integer. Returns -1 if invalid. */
+static int parse_uint(const char *s, size_t len)
+{
+	int value = 0;
+
+	if (len == 0) {
+		return -1;
+	}
+	for (size_t i = 0; i < len; i++) {
+		if (s[i] < '0' || s[i] > '9' || value > (INT_MAX - 9) / 10) {
+			return -1;
+		}
+		value = value * 10 + (s[i] - '0');
+	}
+
+	return value;
+}
+
+/* Get the next element of a comma-separated list. Returns false at the end of the list. */
+static bool list_next(const char **list, size_t *list_len, const char **elem, size_t *elem_len)
+{
+	const char *comma;
+
+	if (*list_len == 0) {
+		return false;
+	}
+
+	comma = memchr(*list, ',', *list_len);
+	*elem = *list;
+	*elem_len = comma ? comma - *list : *list_len;
+	*list += *elem_len;
+	*list_len -= *elem_len;
+	if (comma) {
+		(*list)++;
+		(*list_len)--;
+	}
+	trim_ows(elem, elem_len);
+
+	return true;
+}
+
+/* Parse the status line, "HTTP/1.x nnn reason" (RFC 9112 §4). */
+static int parse_status_line(struct sm_http_header *parser, const char *line, size_t len)
+{
+	if (len < STRLIT_LEN("HTTP/1.x nnn") || strncmp(line, "HTTP/1.", STRLIT_LEN("HTTP/1.")) ||
+	    line[8] != ' ') {
+		return -EBADMSG;
+	}
+
+	parser->status_code = parse_uint(line + 9, 3);
+	if (parser->status_code < 0 || (len > 12 && line[12] != ' ')) {
+		return -EBADMSG;
+	}
+	parser->status_parsed = true;
+
+	return 0;
+}
+
+/* Parse a field line, "name: value" (RFC 9112 §5). Invalid lines are ignored. */
+static void parse_field_line(struct sm_http_header *parser, const char *line, size_t len)
+{
+	const char *colon = memchr(line, ':', len);
+	const char *name = line;
+	size_t name_len;
+	const char *value;
+	size_t value_len;
+	const char *list;
+	size_t list_len;
+	const char *elem;
+	size_t elem_len;
+
+	if (!colon || colon == line) {
+		return;
+	}
+	name_len = colon - line;
+	value = colon + 1;
+	value_len = len - name_len - 1;
+	trim_ows(&value, &value_len);
+	list = value;
+	list_len = value_len;
+
+	if (token_equal(name, name_len, "Content-Length")) {
+		parser->content_length = parse_uint(value, value_len);
+	} else if (token_equal(name, name_len, "Transfer-Encoding")) {
+		/* Chunked is the last transfer coding when present (RFC 9112 §6.1). */
+		while (list_next(&list, &list_len, &elem, &elem_len)) {
+			parser->chunked = token_equal(elem, elem_len, "chunked");
+		}
+	} else if (token_equal(name, name_len, "Connection")) {
+		while (list_next(&list, &list_len, &elem, &elem_len)) {
+			if (token_equal(elem, elem_len, "close")) {
+				parser->connection_close = true;
+			}
+		}
+	} else if (token_equal(name, name_len, "Keep-Alive")) {
+		while (list_next(&list, &list_len, &elem, &elem_len)) {
+			if (elem_len > STRLIT_LEN("timeout=") &&
+			    strncasecmp(elem, "timeout=", STRLIT_LEN("timeout=")) == 0) {
+				parser->keep_alive_timeout =
+					parse_uint(elem + STRLIT_LEN("timeout="),
+						   elem_len - STRLIT_LEN("timeout="));
+			}
+		}
+	}
+
+	if (parser->field_cb) {
+		parser->field_cb(name, name_len, value, value_len, parser->user_data);
+	}
+}
+
+void sm_http_header_init(struct sm_http_header *parser, sm_http_header_field_cb field_cb,
+			 void *user_data)
+{
+	memset(parser, 0, sizeof(*parser));
+	parser->content_length = -1;
+	parser->keep_alive_timeout = -1;
+	parser->field_cb = field_cb;
+	parser->user_data = user_data;
+}
+
+int sm_http_header_parse(struct sm_http_header *parser, const char *buf, size_t len)
+{
+	while (parser->pos < len) {
+		const char *lf = memchr(buf + parser->pos, '\n', len - parser->pos);
+		const char *line = buf + parser->scan;
+		size_t line_len;
+		int ret;
+
+		if (!lf) {
+			/* Resume the search for the end of the line where it stopped. */
+			parser->pos = len;
+			break;
+		}
+
+		line_len = lf - line;
+		if (line_len > 0 && line[line_len - 1] == '\r') {
+			line_len--;
+		}
+		parser->scan = lf - buf + 1;
+		parser->pos = parser->scan;
+
+		if (!parser->status_parsed) {
+			ret = parse_status_line(parser, line, line_len);
+			if (ret < 0) {
+				return ret;
+			}
+		} else if (line_len == 0) {
+			/* Empty line at the end of the header section. */
+			return parser->scan;
+		} else {
+			parse_field_line(parser, line, line_len);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef SM_HTTP_HEADER_
+#define SM_HTTP_HEADER_
+
+/** @file sm_http_header.h
+ *
+ * @brief Incremental parser for the header section of HTTP/1.1 responses (RFC 9112)
+ * @{
+ */
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Callback for a header field of the response.
+ *
+ * @param name Field name, not NUL-terminated.
+ * @param name_len Length of the field name.
+ * @param value Field value without the surrounding whitespace, not NUL-terminated.
+ * @param value_len Length of the field value.
+ * @param user_data User data given to @ref sm_http_header_init.
+ */
+typedef void (*sm_http_header_field_cb)(const char *name, size_t name_len, const char *value,
+					size_t value_len, void *user_data);
+
+/**
+ * @brief State of a response header parser.
+ *
+ * The parser remembers the position up to which the header section has been parsed,
+ * so every received byte is scanned once, however the header section is split over reads.
+ */
+struct sm_http_header {
+	size_t scan;            /* Start of the first line not parsed yet */
+	size_t pos;             /* Position up to which the line has been searched for its end */
+	bool status_parsed;     /* Status line has been parsed */
+	int status_code;        /* Status code of the status line */
+	int content_length;     /* Content-Length, -1 if not present */
+	int keep_alive_timeout; /* Timeout parameter of Keep-Alive, -1 if not present */
+	bool chunked;           /* Transfer-Encoding is chunked */
+	bool connection_close;  /* Connection has the close option */
+	sm_http_header_field_cb field_cb;
+	void *user_data;
+};
+
+/**
+ * @brief Initialize a parser for a new response.
+ *
+ * @param parser Parser.
+ * @param field_cb Callback called for every header field, or NULL.
+ * @param user_data User data given to @p field_cb.
+ */
+void sm_http_header_init(struct sm_http_header *parser, sm_http_header_field_cb field_cb,
+			 void *user_data);
+
+/**
+ * @brief Parse the response bytes received so far.
+ *
+ * Only the complete lines after the ones parsed by the previous call are parsed.
+ * @p buf must hold the same response bytes from its start in every call.
+ *
+ * @param parser Parser.
+ * @param buf Response bytes received so far.
+ * @param len Amount of response bytes received so far.
+ *
+ * @retval Length of the header section when its end has been parsed, so the body starts
+ *         at this offset. 0 if more bytes are needed. -EBADMSG on an invalid status line.
+ */
+int sm_http_header_parse(struct sm_http_header *parser, const char *buf, size_t len);
+
+/** @} */
+
+#endif /* SM_HTTP_HEADER_ */
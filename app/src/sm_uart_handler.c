@@ -31,25 +31,54 @@ uint32_t sm_uart_baudrate;
 static int sm_uart_pipe_init_internal(void);
 struct rx_buf_t {
 	atomic_t ref_counter;
-	size_t len;
-	uint8_t buf[CONFIG_SM_UART_RX_BUF_SIZE];
+	size_t size;
+	uint8_t buf[];
 };
 
-#define UART_SLAB_BLOCK_SIZE sizeof(struct rx_buf_t)
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+/* Buffers of the active size are allocated from a shared pool, so that the amount of buffers
+ * grows when the buffer size shrinks.
+ */
+#define UART_RX_POOL_SIZE CONFIG_SM_UART_RX_BUF_POOL_SIZE
+K_HEAP_DEFINE(rx_heap, UART_RX_POOL_SIZE);
+
+/* Minimum buffer size and the time that one buffer should hold at the current baud rate. */
+#define UART_RX_BUF_MIN_SIZE 128
+#define UART_RX_BUF_FILL_MS 5
+#else
+#define UART_SLAB_BLOCK_SIZE (sizeof(struct rx_buf_t) + CONFIG_SM_UART_RX_BUF_SIZE)
 #define UART_SLAB_BLOCK_COUNT CONFIG_SM_UART_RX_BUF_COUNT
 #define UART_SLAB_ALIGNMENT 4
-BUILD_ASSERT((sizeof(struct rx_buf_t) % UART_SLAB_ALIGNMENT) == 0);
+BUILD_ASSERT((UART_SLAB_BLOCK_SIZE % UART_SLAB_ALIGNMENT) == 0);
 K_MEM_SLAB_DEFINE(rx_slab, UART_SLAB_BLOCK_SIZE, UART_SLAB_BLOCK_COUNT, UART_SLAB_ALIGNMENT);
 
+#define UART_RX_POOL_SIZE (CONFIG_SM_UART_RX_BUF_COUNT * CONFIG_SM_UART_RX_BUF_SIZE)
+#endif
+
 /* 4 messages for 512 bytes, 32 messages for 4096 bytes. */
-#define UART_RX_EVENT_COUNT ((CONFIG_SM_UART_RX_BUF_COUNT * CONFIG_SM_UART_RX_BUF_SIZE) / 128)
-#define UART_RX_EVENT_COUNT_FOR_BUF (UART_RX_EVENT_COUNT / CONFIG_SM_UART_RX_BUF_COUNT)
+#define UART_RX_EVENT_COUNT (UART_RX_POOL_SIZE / 128)
 struct rx_event_t {
+	struct rx_buf_t *block;
 	uint8_t *buf;
 	size_t len;
 };
 K_MSGQ_DEFINE(rx_event_queue, sizeof(struct rx_event_t), UART_RX_EVENT_COUNT, 4);
 
+static struct {
+	atomic_t buf_size;
+	atomic_t bufs_in_use;
+	atomic_t bufs_peak;
+	atomic_t rx_bytes;
+	atomic_t stalls;
+	atomic_t dropped;
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+	atomic_t stalls_at_resize;
+#endif
+} rx_pool = {
+	.buf_size = ATOMIC_INIT(CONFIG_SM_UART_RX_BUF_SIZE),
+};
+static struct rx_event_t rx_claimed;
+
 RING_BUF_DECLARE(tx_buf, CONFIG_SM_UART_TX_BUF_SIZE);
 
 enum sm_uart_state {
@@ -76,52 +105,118 @@ static struct {
 
 K_SEM_DEFINE(tx_done_sem, 0, 1);
 
+#if defined(CONFIG_SM_UART_TX_ZERO_COPY)
+/* Transfer sent directly from the caller buffer. */
+static struct {
+	bool active;
+	size_t sent;
+	struct k_sem done;
+} tx_direct = {
+	.done = Z_SEM_INITIALIZER(tx_direct.done, 0, 1),
+};
+#endif
+
 static inline struct rx_buf_t *block_start_get(uint8_t *buf)
 {
-	size_t block_num;
+	/* The async UART driver reports buffers with the address given to it. */
+	return CONTAINER_OF(buf, struct rx_buf_t, buf);
+}
+
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+/* Returns the buffer size that holds UART_RX_BUF_FILL_MS of data at the current baud rate. */
+static size_t rx_buf_size_target(void)
+{
+	/* 10 bits per byte on the line. */
+	size_t size = ROUND_UP(sm_uart_baudrate / 10 * UART_RX_BUF_FILL_MS / 1000, 4);
+
+	return CLAMP(size, UART_RX_BUF_MIN_SIZE, CONFIG_SM_UART_RX_BUF_SIZE);
+}
+
+/* Shrinks the buffers when reception stalls, so that more of them fit in the pool. */
+static void rx_buf_size_shrink(void)
+{
+	size_t size = atomic_get(&rx_pool.buf_size);
 
-	/* blocks are fixed size units from a continuous memory slab: */
-	/* round down to the closest unit size to find beginning of block. */
+	if (size > UART_RX_BUF_MIN_SIZE) {
+		atomic_set(&rx_pool.buf_size, MAX(ROUND_UP(size / 2, 4), UART_RX_BUF_MIN_SIZE));
+	}
+}
 
-	block_num =
-		(((size_t)buf - (size_t)rx_slab.buffer) / UART_SLAB_BLOCK_SIZE);
+/* Grows the buffers back towards the target once the received data has been processed
+ * without stalls since the previous resize.
+ */
+static void rx_buf_size_grow(void)
+{
+	size_t size = atomic_get(&rx_pool.buf_size);
+	size_t target = rx_buf_size_target();
+	atomic_val_t stalls = atomic_get(&rx_pool.stalls);
 
-	return (struct rx_buf_t *) &rx_slab.buffer[block_num * UART_SLAB_BLOCK_SIZE];
+	if (size >= target || stalls != atomic_get(&rx_pool.stalls_at_resize)) {
+		atomic_set(&rx_pool.stalls_at_resize, stalls);
+		return;
+	}
+
+	atomic_set(&rx_pool.buf_size, MIN(size * 2, target));
+}
+#endif
+
+/* Returns the amount of event queue space to reserve for a buffer. */
+static size_t rx_event_count_for_buf(void)
+{
+	return MAX(1, atomic_get(&rx_pool.buf_size) / 128);
 }
 
 static struct rx_buf_t *rx_buf_alloc(void)
 {
 	struct rx_buf_t *buf;
-	int err;
+	size_t size = atomic_get(&rx_pool.buf_size);
+	atomic_val_t in_use;
+	atomic_val_t peak;
 
 	/* Async UART driver returns pointers to received data as */
 	/* offsets from beginning of RX buffer block. */
 	/* This code uses a reference counter to keep track of the number of */
 	/* references within a single RX buffer block */
 
-	err = k_mem_slab_alloc(&rx_slab, (void **) &buf, K_NO_WAIT);
-	if (err) {
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+	buf = k_heap_alloc(&rx_heap, sizeof(struct rx_buf_t) + size, K_NO_WAIT);
+	if (!buf) {
 		return NULL;
 	}
+#else
+	if (k_mem_slab_alloc(&rx_slab, (void **) &buf, K_NO_WAIT)) {
+		return NULL;
+	}
+#endif
 
 	atomic_set(&buf->ref_counter, 1);
+	buf->size = size;
+
+	in_use = atomic_inc(&rx_pool.bufs_in_use) + 1;
+	do {
+		peak = atomic_get(&rx_pool.bufs_peak);
+	} while (in_use > peak && !atomic_cas(&rx_pool.bufs_peak, peak, in_use));
 
 	return buf;
 }
 
-static void rx_buf_ref(void *buf)
+static void rx_buf_ref(struct rx_buf_t *buf)
 {
-	atomic_inc(&(block_start_get(buf)->ref_counter));
+	atomic_inc(&buf->ref_counter);
 }
 
-static void rx_buf_unref(void *buf)
+static void rx_buf_unref(struct rx_buf_t *buf)
 {
-	struct rx_buf_t *uart_buf = block_start_get(buf);
-	atomic_t ref_counter = atomic_dec(&uart_buf->ref_counter);
+	atomic_t ref_counter = atomic_dec(&buf->ref_counter);
 
-	/* ref_counter is the uart_buf->ref_counter value prior to decrement */
+	/* ref_counter is the buf->ref_counter value prior to decrement */
 	if (ref_counter == 1) {
-		k_mem_slab_free(&rx_slab, (void *)uart_buf);
+		atomic_dec(&rx_pool.bufs_in_use);
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+		k_heap_free(&rx_heap, buf);
+#else
+		k_mem_slab_free(&rx_slab, (void *)buf);
+#endif
 	}
 }
 
@@ -141,7 +236,7 @@ static int rx_enable(void)
 		return -ENOMEM;
 	}
 
-	ret = uart_rx_enable(sm_uart_dev, buf->buf, sizeof(buf->buf), UART_RX_TIMEOUT_US);
+	ret = uart_rx_enable(sm_uart_dev, buf->buf, buf->size, UART_RX_TIMEOUT_US);
 	if (ret) {
 		LOG_ERR("UART RX enable failed: %d", ret);
 		rx_buf_unref(buf);
@@ -196,6 +291,16 @@ static void rx_recovery(void)
 	atomic_clear_bit(&uart_state, SM_UART_STATE_RX_RECOVERY_BIT);
 }
 
+/* Called when all the received data has been processed. */
+static void rx_drained(void)
+{
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+	rx_buf_size_grow();
+#endif
+	/* Try to recover RX, in case it was disabled. */
+	rx_recovery();
+}
+
 static void tx_enable(void)
 {
 	if (!atomic_test_and_set_bit(&uart_state, SM_UART_STATE_TX_ENABLED_BIT)) {
@@ -282,6 +387,22 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 	switch (evt->type) {
 	case UART_TX_DONE:
 	case UART_TX_ABORTED:
+#if defined(CONFIG_SM_UART_TX_ZERO_COPY)
+		if (tx_direct.active) {
+			tx_direct.active = false;
+			tx_direct.sent = evt->data.tx.len;
+			if (ring_buf_is_empty(&tx_buf) ||
+			    (evt->type == UART_TX_ABORTED &&
+			     !atomic_test_bit(&uart_state, SM_UART_STATE_TX_ENABLED_BIT))) {
+				k_sem_give(&tx_done_sem);
+			} else {
+				tx_start();
+			}
+			k_sem_give(&tx_direct.done);
+			uart_callback_notify_pipe_transmit_idle();
+			break;
+		}
+#endif
 		err = ring_buf_get_finish(&tx_buf, evt->data.tx.len);
 		if (err) {
 			LOG_ERR("UART_TX_%s failure: %d",
@@ -304,28 +425,36 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 			 */
 			break;
 		}
-		rx_buf_ref(evt->data.rx.buf);
+		rx_event.block = block_start_get(evt->data.rx.buf);
 		rx_event.buf = &evt->data.rx.buf[evt->data.rx.offset];
 		rx_event.len = evt->data.rx.len;
+		rx_buf_ref(rx_event.block);
+		atomic_add(&rx_pool.rx_bytes, evt->data.rx.len);
 		err = k_msgq_put(&rx_event_queue, &rx_event, K_NO_WAIT);
 		if (err) {
 			LOG_ERR("RX event queue full, dropped %zu bytes", evt->data.rx.len);
-			rx_buf_unref(evt->data.rx.buf);
+			atomic_add(&rx_pool.dropped, evt->data.rx.len);
+			rx_buf_unref(rx_event.block);
 			break;
 		}
 		modem_pipe_notify_receive_ready(&sm_pipe.pipe);
 		break;
 	case UART_RX_BUF_REQUEST:
-		if (k_msgq_num_free_get(&rx_event_queue) < UART_RX_EVENT_COUNT_FOR_BUF) {
+		if (k_msgq_num_free_get(&rx_event_queue) < rx_event_count_for_buf()) {
 			LOG_WRN("Disabling UART RX: No event space.");
+			atomic_inc(&rx_pool.stalls);
 			break;
 		}
 		buf = rx_buf_alloc();
 		if (!buf) {
 			LOG_WRN("Disabling UART RX: No free buffers.");
+			atomic_inc(&rx_pool.stalls);
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+			rx_buf_size_shrink();
+#endif
 			break;
 		}
-		err = uart_rx_buf_rsp(sm_uart_dev, buf->buf, sizeof(buf->buf));
+		err = uart_rx_buf_rsp(sm_uart_dev, buf->buf, buf->size);
 		if (err) {
 			LOG_WRN("Disabling UART RX: %d", err);
 			rx_buf_unref(buf);
@@ -333,7 +462,7 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 		break;
 	case UART_RX_BUF_RELEASED:
 		if (evt->data.rx_buf.buf) {
-			rx_buf_unref(evt->data.rx_buf.buf);
+			rx_buf_unref(block_start_get(evt->data.rx_buf.buf));
 		}
 		break;
 	case UART_RX_DISABLED:
@@ -450,6 +579,10 @@ static int pipe_open(void *data)
 	atomic_set_bit(&sm_pipe.state, SM_PIPE_STATE_OPEN_BIT);
 
 	atomic_clear_bit(&uart_state, SM_UART_STATE_RX_RECOVERY_DISABLED_BIT);
+#if defined(CONFIG_SM_UART_RX_BUF_ADAPTIVE)
+	atomic_set(&rx_pool.buf_size, rx_buf_size_target());
+	atomic_set(&rx_pool.stalls_at_resize, atomic_get(&rx_pool.stalls));
+#endif
 	ret = rx_enable();
 	if (ret) {
 		return ret;
@@ -462,6 +595,41 @@ static int pipe_open(void *data)
 	return 0;
 }
 
+#if defined(CONFIG_SM_UART_TX_ZERO_COPY)
+/* Send directly from the caller buffer. Take tx_done_sem before calling.
+ * Returns the number of bytes sent or a negative error code.
+ */
+static int tx_direct_send(const uint8_t *buf, size_t size)
+{
+	/* Allow twice the time the transfer takes on the line, for flow control. */
+	uint32_t timeout_ms = (uint32_t)(2 * size * (8 + 1 + 1) * 1000ULL / sm_uart_baudrate);
+	int err;
+
+	k_sem_reset(&tx_direct.done);
+	tx_direct.sent = 0;
+	tx_direct.active = true;
+	err = uart_tx(sm_uart_dev, buf, size, SYS_FOREVER_US);
+	if (err) {
+		LOG_ERR("UART TX error: %d", err);
+		tx_direct.active = false;
+		k_sem_give(&tx_done_sem);
+		return err;
+	}
+
+	if (k_sem_take(&tx_direct.done, K_MSEC(timeout_ms + UART_ERROR_DELAY_MS))) {
+		LOG_WRN("UART TX timeout, aborting");
+		err = uart_tx_abort(sm_uart_dev);
+		if (err && err != -EFAULT) {
+			LOG_ERR("uart_tx_abort failed (%d).", err);
+		}
+		/* The buffer is in use until the transfer is completed or aborted. */
+		k_sem_take(&tx_direct.done, K_FOREVER);
+	}
+
+	return (int)tx_direct.sent;
+}
+#endif
+
 /* Returns the number of bytes written or a negative error code. */
 static int pipe_transmit(void *data, const uint8_t *buf, size_t size)
 {
@@ -478,6 +646,20 @@ static int pipe_transmit(void *data, const uint8_t *buf, size_t size)
 		return -EINVAL;
 	}
 
+#if defined(CONFIG_SM_UART_TX_ZERO_COPY)
+	if (size >= CONFIG_SM_UART_TX_ZERO_COPY_THRESHOLD && !k_is_in_isr() &&
+	    atomic_test_bit(&uart_state, SM_UART_STATE_TX_ENABLED_BIT) &&
+	    ring_buf_is_empty(&tx_buf) && k_sem_take(&tx_done_sem, K_NO_WAIT) == 0) {
+		if (ring_buf_is_empty(&tx_buf)) {
+			return tx_direct_send(buf, size);
+		}
+		/* Data was written to the TX buffer meanwhile. Send it first and queue after it. */
+		if (tx_start()) {
+			k_sem_give(&tx_done_sem);
+		}
+	}
+#endif
+
 	while (sent < size) {
 		ret = ring_buf_put(&tx_buf, buf + sent, size - sent);
 		if (ret) {
@@ -527,25 +709,87 @@ static int pipe_receive(void *data, uint8_t *buf, size_t size)
 		buf += copy_size;
 
 		if (rx_event.len == copy_size) {
-			rx_buf_unref(rx_event.buf);
+			rx_buf_unref(rx_event.block);
 		} else {
 			rx_event.len -= copy_size;
 			rx_event.buf += copy_size;
 			err = k_msgq_put_front(&rx_event_queue, &rx_event);
 			if (err) {
 				LOG_ERR("RX event queue full, dropped %zu bytes", rx_event.len);
-				rx_buf_unref(rx_event.buf);
+				atomic_add(&rx_pool.dropped, rx_event.len);
+				rx_buf_unref(rx_event.block);
 			}
 		}
 	}
 	if (k_msgq_num_used_get(&rx_event_queue) == 0) {
-		/* Try to recover RX, in case it was disabled. */
-		rx_recovery();
+		rx_drained();
 	}
 
 	return (int)received;
 }
 
+int sm_uart_rx_claim(const uint8_t **data)
+{
+	if (!data) {
+		return -EINVAL;
+	}
+
+	if (rx_claimed.buf) {
+		return -EBUSY;
+	}
+
+	if (k_msgq_get(&rx_event_queue, &rx_claimed, K_NO_WAIT)) {
+		rx_claimed.buf = NULL;
+		rx_drained();
+		return 0;
+	}
+
+	*data = rx_claimed.buf;
+
+	return (int)rx_claimed.len;
+}
+
+void sm_uart_rx_finish(size_t len)
+{
+	struct rx_event_t rx_event = rx_claimed;
+	int err;
+
+	if (!rx_event.buf) {
+		return;
+	}
+	rx_claimed.buf = NULL;
+
+	if (len >= rx_event.len) {
+		rx_buf_unref(rx_event.block);
+	} else {
+		rx_event.len -= len;
+		rx_event.buf += len;
+		err = k_msgq_put_front(&rx_event_queue, &rx_event);
+		if (err) {
+			LOG_ERR("RX event queue full, dropped %zu bytes", rx_event.len);
+			atomic_add(&rx_pool.dropped, rx_event.len);
+			rx_buf_unref(rx_event.block);
+		}
+	}
+	if (k_msgq_num_used_get(&rx_event_queue) == 0) {
+		rx_drained();
+	}
+}
+
+void sm_uart_rx_stats_get(struct sm_uart_rx_stats *stats)
+{
+	if (!stats) {
+		return;
+	}
+
+	stats->buf_size = atomic_get(&rx_pool.buf_size);
+	stats->bufs_in_use = atomic_get(&rx_pool.bufs_in_use);
+	stats->bufs_peak = atomic_get(&rx_pool.bufs_peak);
+	stats->rx_bytes = atomic_get(&rx_pool.rx_bytes);
+	stats->stalls = atomic_get(&rx_pool.stalls);
+	stats->dropped = atomic_get(&rx_pool.dropped);
+}
+
 static int pipe_close(void *data)
 {
 	ARG_UNUSED(data);
@@ -651,6 +895,7 @@ static int handle_at_ipr(enum at_parser_cmd_type cmd_type, struct at_parser *par
 		LOG_ERR("uart_configure: %d", err);
 		return err;
 	}
+	sm_uart_baudrate = cfg.baudrate;
 	err = modem_pipe_open(&sm_pipe.pipe, K_SECONDS(1));
 	if (err) {
 		LOG_ERR("modem_pipe_open: %d", err);
@@ -659,3 +904,23 @@ static int handle_at_ipr(enum at_parser_cmd_type cmd_type, struct at_parser *par
 
 	return -SILENT_AT_COMMAND_RET;
 }
+
+SM_AT_CMD_CUSTOM(xuartstat, "AT#XUARTSTAT", handle_at_uartstat);
+static int handle_at_uartstat(enum at_parser_cmd_type cmd_type, struct at_parser *parser,
+			      uint32_t param_count)
+{
+	struct sm_uart_rx_stats stats;
+
+	ARG_UNUSED(parser);
+	ARG_UNUSED(param_count);
+
+	if (cmd_type != AT_PARSER_CMD_TYPE_SET) {
+		return -EINVAL;
+	}
+
+	sm_uart_rx_stats_get(&stats);
+	rsp_send("\r\n#XUARTSTAT: %u,%u,%u,%u,%u,%u\r\n", stats.buf_size, stats.bufs_in_use,
+		 stats.bufs_peak, stats.rx_bytes, stats.stalls, stats.dropped);
+
+	return 0;
+}
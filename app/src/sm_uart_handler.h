@@ -35,6 +35,50 @@ typedef int (*sm_pipe_tx_t)(const uint8_t *data, size_t len, bool urc);
  */
 struct modem_pipe *sm_uart_pipe_get(void);
 
+/**
+ * @brief Claim received UART data in place.
+ *
+ * The data stays in the UART receive buffer until it is released with @ref sm_uart_rx_finish.
+ * Only one claim can be active at a time.
+ *
+ * @param data Set to point to the received data.
+ *
+ * @retval Amount of bytes claimed, 0 if there is no data, otherwise a negative error code.
+ */
+int sm_uart_rx_claim(const uint8_t **data);
+
+/**
+ * @brief Release UART data claimed with @ref sm_uart_rx_claim.
+ *
+ * Data that was not consumed is returned to the front of the receive queue.
+ *
+ * @param len Amount of bytes consumed.
+ */
+void sm_uart_rx_finish(size_t len);
+
+/** @brief UART receive statistics. */
+struct sm_uart_rx_stats {
+	/** Size of the receive buffers that are allocated. */
+	uint32_t buf_size;
+	/** Amount of receive buffers in use. */
+	uint32_t bufs_in_use;
+	/** Peak amount of receive buffers in use. */
+	uint32_t bufs_peak;
+	/** Amount of bytes received. */
+	uint32_t rx_bytes;
+	/** Times reception was disabled because no buffer or event space was available. */
+	uint32_t stalls;
+	/** Amount of bytes dropped because the receive event queue was full. */
+	uint32_t dropped;
+};
+
+/**
+ * @brief Get the UART receive statistics.
+ *
+ * @param stats Filled with the statistics.
+ */
+void sm_uart_rx_stats_get(struct sm_uart_rx_stats *stats);
+
 /** @} */
 
 #endif /* SM_UART_HANDLER_ */
@@ -13,7 +13,9 @@
 #include <zephyr/storage/flash_map.h>
 #include <nrf_errno.h>
 #include <nrf_modem_at.h>
+#include <modem/at_monitor.h>
 #include "sm_util.h"
+#include "sm_defines.h"
 #include <fw_info.h>
 #include <tfm/tfm_ioctl_api.h>
 
@@ -292,9 +294,192 @@ int util_str_to_int(const char *str_buf, int base, int *output)
 	return 0;
 }
 
+/* Hex digit pairs of all byte values. */
+static const char hex_pairs[512 + 1] =
+	"000102030405060708090a0b0c0d0e0f"
+	"101112131415161718191a1b1c1d1e1f"
+	"202122232425262728292a2b2c2d2e2f"
+	"303132333435363738393a3b3c3d3e3f"
+	"404142434445464748494a4b4c4d4e4f"
+	"505152535455565758595a5b5c5d5e5f"
+	"606162636465666768696a6b6c6d6e6f"
+	"707172737475767778797a7b7c7d7e7f"
+	"808182838485868788898a8b8c8d8e8f"
+	"909192939495969798999a9b9c9d9e9f"
+	"a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+	"b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+	"c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+	"d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+	"e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+	"f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/* Hex digit values plus one, 0 for characters that are not hex digits. */
+static const uint8_t hex_values[256] = {
+	['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+	['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+	['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+	['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+};
+
+size_t util_bin2hex(const uint8_t *buf, size_t buflen, char *hex, size_t hexlen)
+{
+	if (hexlen < buflen * 2 + 1) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < buflen; i++) {
+		memcpy(&hex[i * 2], &hex_pairs[buf[i] * 2], 2);
+	}
+	hex[buflen * 2] = '\0';
+
+	return buflen * 2;
+}
+
+size_t util_hex2bin(const char *hex, size_t hexlen, uint8_t *buf, size_t buflen)
+{
+	const uint8_t *in = (const uint8_t *)hex;
+	size_t len = hexlen / 2 + hexlen % 2;
+	size_t i = 0;
+
+	if (buflen < len) {
+		return 0;
+	}
+
+	/* An odd leading digit is the low nibble of the first byte. */
+	if (hexlen % 2) {
+		if (hex_values[in[0]] == 0) {
+			return 0;
+		}
+		buf[i++] = hex_values[in[0]] - 1;
+		in++;
+	}
+
+	for (; i < len; i++, in += 2) {
+		uint8_t high = hex_values[in[0]];
+		uint8_t low = hex_values[in[1]];
+
+		if (high == 0 || low == 0) {
+			return 0;
+		}
+		buf[i] = ((high - 1) << 4) | (low - 1);
+	}
+
+	return len;
+}
+
 #define PORT_MAX_SIZE    5 /* 0xFFFF = 65535 */
 #define PDN_ID_MAX_SIZE  2 /* 0..10 */
 
+#if defined(CONFIG_SM_DNS_CACHE)
+
+struct dns_cache_entry {
+	char host[SM_MAX_URL];
+	int cid;
+	int family;
+	struct net_sockaddr sa;
+	/* k_uptime_get() time after which the entry is not used. 0 if the entry is free. */
+	int64_t expiry;
+};
+
+static struct dns_cache_entry dns_cache[CONFIG_SM_DNS_CACHE_SIZE];
+static K_MUTEX_DEFINE(dns_cache_mutex);
+
+static void dns_cache_port_set(struct net_sockaddr *sa, uint16_t port)
+{
+	if (sa->sa_family == NET_AF_INET) {
+		net_sin(sa)->sin_port = net_htons(port);
+	} else {
+		net_sin6(sa)->sin6_port = net_htons(port);
+	}
+}
+
+static bool dns_cache_get(int cid, const char *host, uint16_t port, int family,
+			  struct net_sockaddr *sa)
+{
+	const int64_t now = k_uptime_get();
+	bool found = false;
+
+	k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+	for (size_t i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		struct dns_cache_entry *entry = &dns_cache[i];
+
+		if (entry->expiry == 0 || entry->cid != cid || entry->family != family ||
+		    strcmp(entry->host, host) != 0) {
+			continue;
+		}
+		if (entry->expiry <= now) {
+			entry->expiry = 0;
+			break;
+		}
+		*sa = entry->sa;
+		dns_cache_port_set(sa, port);
+		found = true;
+		break;
+	}
+	k_mutex_unlock(&dns_cache_mutex);
+
+	return found;
+}
+
+static void dns_cache_put(int cid, const char *host, int family, const struct net_sockaddr *sa)
+{
+	struct dns_cache_entry *entry = &dns_cache[0];
+
+	if (strlen(host) >= sizeof(entry->host)) {
+		return;
+	}
+
+	k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+	/* Replace a free entry or the one that expires first. */
+	for (size_t i = 1; i < ARRAY_SIZE(dns_cache) && entry->expiry != 0; i++) {
+		if (dns_cache[i].expiry < entry->expiry) {
+			entry = &dns_cache[i];
+		}
+	}
+	strcpy(entry->host, host);
+	entry->cid = cid;
+	entry->family = family;
+	entry->sa = *sa;
+	entry->expiry = k_uptime_get() + CONFIG_SM_DNS_CACHE_TTL * MSEC_PER_SEC;
+	k_mutex_unlock(&dns_cache_mutex);
+}
+
+/* Invalidate the entries of a PDP context, or all of them if cid is negative. */
+static void dns_cache_invalidate(int cid)
+{
+	k_mutex_lock(&dns_cache_mutex, K_FOREVER);
+	for (size_t i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		if (cid < 0 || dns_cache[i].cid == cid) {
+			dns_cache[i].expiry = 0;
+		}
+	}
+	k_mutex_unlock(&dns_cache_mutex);
+}
+
+/* PDN and packet domain events change the DNS servers and addresses of the PDP contexts.
+ * Events for a single PDP context end with its CID, for example "+CGEV: ME PDN DEACT 0".
+ * Others, like "+CGEV: NW DETACH", concern all of them.
+ */
+static void dns_cache_on_cgev(const char *notify)
+{
+	const char *param = strrchr(notify, ' ');
+	char *end;
+	long cid = -1;
+
+	if (param && isdigit((unsigned char)param[1])) {
+		cid = strtol(param + 1, &end, 10);
+		if (*end != '\0' && *end != ',' && *end != '\r' && *end != '\n') {
+			cid = -1;
+		}
+	}
+	LOG_DBG("Invalidate DNS cache for CID %ld", cid);
+	dns_cache_invalidate(cid);
+}
+
+AT_MONITOR(sm_util_dns_cache_cgev, "CGEV", dns_cache_on_cgev);
+
+#endif /* CONFIG_SM_DNS_CACHE */
+
 int util_resolve_host(int cid, const char *host, uint16_t port, int family, struct net_sockaddr *sa)
 {
 	int err;
@@ -309,6 +494,12 @@ int util_resolve_host(int cid, const char *host, uint16_t port, int family, stru
 		return DNS_EAI_AGAIN;
 	}
 
+#if defined(CONFIG_SM_DNS_CACHE)
+	if (dns_cache_get(cid, host, port, family, sa)) {
+		return 0;
+	}
+#endif
+
 	/* "service" shall be formatted as follows: "port:pdn_id" */
 	snprintf(service, sizeof(service), "%hu:%d", port, cid);
 	err = zsock_getaddrinfo(host, service, &hints, &ai);
@@ -320,6 +511,11 @@ int util_resolve_host(int cid, const char *host, uint16_t port, int family, stru
 			err = DNS_EAI_ADDRFAMILY;
 		}
 	}
+#if defined(CONFIG_SM_DNS_CACHE)
+	if (!err) {
+		dns_cache_put(cid, host, family, sa);
+	}
+#endif
 
 	if (err) {
 		const char *errstr;
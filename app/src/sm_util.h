@@ -128,6 +128,35 @@ void util_get_ip_addr(int cid, char addr4[NET_INET_ADDRSTRLEN], char addr6[NET_I
  */
 int util_str_to_int(const char *str, int base, int *output);
 
+/**
+ * @brief Convert binary data to a hex string
+ *
+ * Same as bin2hex() of Zephyr, with a table lookup for each byte.
+ *
+ * @param[in] buf Binary data.
+ * @param[in] buflen Length of the binary data.
+ * @param[out] hex Buffer for the hex string, including the null terminator.
+ * @param[in] hexlen Size of the hex string buffer.
+ *
+ * @return Length of the hex string, or 0 if the buffer is too small.
+ */
+size_t util_bin2hex(const uint8_t *buf, size_t buflen, char *hex, size_t hexlen);
+
+/**
+ * @brief Convert a hex string to binary data
+ *
+ * Same as hex2bin() of Zephyr, with a table lookup for each digit.
+ * With an odd number of digits, the first digit is the low nibble of the first byte.
+ *
+ * @param[in] hex Hex string, upper or lower case.
+ * @param[in] hexlen Length of the hex string.
+ * @param[out] buf Buffer for the binary data.
+ * @param[in] buflen Size of the binary data buffer.
+ *
+ * @return Length of the binary data, or 0 on an invalid digit or if the buffer is too small.
+ */
+size_t util_hex2bin(const char *hex, size_t hexlen, uint8_t *buf, size_t buflen);
+
 /**
  * @brief Resolve remote host by host name or IP address
  *
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file test_at_cmd_index.c
+ * Unit tests and dispatch benchmark for sm_at_cmd_index.c
+ */
+
+#include <unity.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <zephyr/kernel.h>
+
+#include "sm_at_cmd_index.h"
+
+static int test_cb(char *buf, size_t len, char *at_cmd)
+{
+	return 0;
+}
+
+#define ENTRY(_filter) {.cmd = _filter, .callback = test_cb, .cmd_strlen = sizeof(_filter) - 1}
+
+/* Custom AT commands of Serial Modem, in link order (sorted by entry name). */
+static const struct nrf_modem_at_cmd_custom table[] = {
+	ENTRY("AT+CFUN="), ENTRY("AT+CGEREP"), ENTRY("ATE0"), ENTRY("ATE1"), ENTRY("AT+CMUX"),
+	ENTRY("AT+CGDATA"), ENTRY("AT+IPR"), ENTRY("AT#XACCEPT"), ENTRY("AT#XAPOLL"),
+	ENTRY("AT#XBIND"), ENTRY("AT#XBOOTINFO"), ENTRY("AT#XCARRIER=\"app_data_create\""),
+	ENTRY("AT#XCARRIER=\"app_data_set\""), ENTRY("AT#XCARRIER=\"battery_level\""),
+	ENTRY("AT#XCARRIER=\"time\""), ENTRY("AT#XCARRIER=\"timezone\""),
+	ENTRY("AT#XCARRIERCFG=\"apn\""), ENTRY("AT#XCARRIERCFG=\"auto_register\""),
+	ENTRY("AT#XCLAC"), ENTRY("AT#XCLOSE"), ENTRY("AT#XCMUX"), ENTRY("AT#XCMUXCLD"),
+	ENTRY("AT#XCMUXTRACE"), ENTRY("AT#XCOAPCCANCEL"), ENTRY("AT#XCOAPCDATA"),
+	ENTRY("AT#XCOAPCREQ"), ENTRY("AT#XCONNECT"), ENTRY("AT#XDATACTRL"), ENTRY("AT#XDFUAPPLY"),
+	ENTRY("AT#XDFUINIT"), ENTRY("AT#XDFUWRITE"), ENTRY("AT#XFOTA"), ENTRY("AT#XGETADDRINFO"),
+	ENTRY("AT#XGNSS"), ENTRY("AT#XGNSSDEL"), ENTRY("AT#XHTTPCCANCEL"), ENTRY("AT#XHTTPCDATA"),
+	ENTRY("AT#XHTTPCREQ"), ENTRY("AT#XLISTEN"), ENTRY("AT#XLOG"), ENTRY("AT#XMODEMRESET"),
+	ENTRY("AT#XMQTTCFG"), ENTRY("AT#XMQTTCON"), ENTRY("AT#XMQTTPUB"), ENTRY("AT#XMQTTSUB"),
+	ENTRY("AT#XMQTTUNSUB"), ENTRY("AT#XNRFCLOUD"), ENTRY("AT#XNRFCLOUDPOS"),
+	ENTRY("AT#XNRFPROV"), ENTRY("AT#XPING"), ENTRY("AT#XPPP"), ENTRY("AT#XRECV"),
+	ENTRY("AT#XRECVCFG"), ENTRY("AT#XRECVFROM"), ENTRY("AT#XRESET"), ENTRY("AT#XSEND"),
+	ENTRY("AT#XSENDTO"), ENTRY("AT#XSHUTDOWN"), ENTRY("AT#XSLEEP"), ENTRY("AT#XSMS"),
+	ENTRY("AT#XSMVER"), ENTRY("AT#XSOCKET"), ENTRY("AT#XSOCKETOPT"), ENTRY("AT#XSSOCKET"),
+	ENTRY("AT#XSSOCKETOPT"), ENTRY("AT#XTRACE"), ENTRY("AT#XUARTSTAT"), ENTRY("AT#XUUID"),
+};
+
+static struct sm_at_cmd_index cmd_index;
+
+static const struct nrf_modem_at_cmd_custom *entry_get(const char *filter)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(table); i++) {
+		if (!strcmp(table[i].cmd, filter)) {
+			return &table[i];
+		}
+	}
+
+	TEST_FAIL_MESSAGE("Filter not in table");
+	return NULL;
+}
+
+/* Linear walk over the filters, as done by the modem library without the index. */
+static const struct nrf_modem_at_cmd_custom *linear_find(const char *at_cmd)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(table); i++) {
+		if (strncasecmp(at_cmd, table[i].cmd, table[i].cmd_strlen) == 0) {
+			return &table[i];
+		}
+	}
+
+	return NULL;
+}
+
+void setUp(void)
+{
+	TEST_ASSERT_EQUAL(0, sm_at_cmd_index_build(&cmd_index, table, ARRAY_SIZE(table)));
+}
+
+void tearDown(void)
+{
+}
+
+void test_find_all_entries(void)
+{
+	char at_cmd[64];
+
+	for (size_t i = 0; i < ARRAY_SIZE(table); i++) {
+		snprintf(at_cmd, sizeof(at_cmd), "%s", table[i].cmd);
+		TEST_ASSERT_EQUAL_PTR(&table[i], sm_at_cmd_index_find(&cmd_index, at_cmd));
+	}
+}
+
+void test_find_operations(void)
+{
+	const struct nrf_modem_at_cmd_custom *socket = entry_get("AT#XSOCKET");
+
+	TEST_ASSERT_EQUAL_PTR(socket, sm_at_cmd_index_find(&cmd_index, "AT#XSOCKET=1,1,0"));
+	TEST_ASSERT_EQUAL_PTR(socket, sm_at_cmd_index_find(&cmd_index, "AT#XSOCKET?"));
+	TEST_ASSERT_EQUAL_PTR(socket, sm_at_cmd_index_find(&cmd_index, "AT#XSOCKET=?"));
+	TEST_ASSERT_EQUAL_PTR(socket, sm_at_cmd_index_find(&cmd_index, "at#xsocket?"));
+}
+
+void test_find_exact_base(void)
+{
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT#XSENDTO"),
+			      sm_at_cmd_index_find(&cmd_index, "AT#XSENDTO=\"host\",1234"));
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT#XSEND"), sm_at_cmd_index_find(&cmd_index, "AT#XSEND=\"a\""));
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT#XNRFCLOUDPOS"),
+			      sm_at_cmd_index_find(&cmd_index, "AT#XNRFCLOUDPOS=1,0"));
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT#XNRFCLOUD"),
+			      sm_at_cmd_index_find(&cmd_index, "AT#XNRFCLOUD?"));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT#XSENDX"));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT#XSEN"));
+}
+
+void test_find_filter_with_parameter(void)
+{
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT#XCARRIER=\"timezone\""),
+			      sm_at_cmd_index_find(&cmd_index, "AT#XCARRIER=\"timezone\",\"UTC\""));
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT#XCARRIER=\"time\""),
+			      sm_at_cmd_index_find(&cmd_index, "AT#XCARRIER=\"time\""));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT#XCARRIER=\"unknown\""));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT#XCARRIER?"));
+
+	TEST_ASSERT_EQUAL_PTR(entry_get("AT+CFUN="), sm_at_cmd_index_find(&cmd_index, "AT+CFUN=0"));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT+CFUN?"));
+}
+
+void test_find_modem_commands(void)
+{
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT+CGMR"));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT%XSYSTEMMODE?"));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT"));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, ""));
+}
+
+void test_build_too_many(void)
+{
+	TEST_ASSERT_EQUAL(-E2BIG, sm_at_cmd_index_build(&cmd_index, table, SM_AT_CMD_INDEX_MAX + 1));
+	TEST_ASSERT_NULL(sm_at_cmd_index_find(&cmd_index, "AT#XSOCKET?"));
+}
+
+/*
+ * Benchmark: per-command dispatch time with the index and with a linear walk.
+ * native_sim does not advance the cycle counter during computation, so the times are
+ * only measured on target, for example with:
+ * west twister -T app/tests/at_cmd_index -p nrf9151dk/nrf9151/ns --device-testing
+ *   --device-serial <port>
+ */
+#define BENCH_ROUNDS 1000
+
+void test_benchmark_dispatch(void)
+{
+	static const char *const cmds[] = {
+		"ATE1", "AT#XACCEPT=60", "AT#XSEND=\"data\"", "AT#XRECV=0,100", "AT#XUUID",
+		"AT#XCARRIER=\"time\"", "AT#XMQTTPUB=\"topic\"", "AT+CGMR", "AT%XSYSTEMMODE?",
+	};
+	uint32_t index_cycles[ARRAY_SIZE(cmds)] = {0};
+	uint32_t linear_cycles[ARRAY_SIZE(cmds)] = {0};
+	const void *volatile found;
+	uint32_t start;
+
+	for (int round = 0; round < BENCH_ROUNDS; round++) {
+		for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+			start = k_cycle_get_32();
+			found = sm_at_cmd_index_find(&cmd_index, cmds[i]);
+			index_cycles[i] += k_cycle_get_32() - start;
+
+			start = k_cycle_get_32();
+			found = linear_find(cmds[i]);
+			linear_cycles[i] += k_cycle_get_32() - start;
+		}
+	}
+	(void)found;
+
+	for (size_t i = 0; i < ARRAY_SIZE(cmds); i++) {
+		TEST_ASSERT_EQUAL_PTR(linear_find(cmds[i]),
+				      sm_at_cmd_index_find(&cmd_index, cmds[i]));
+		if (IS_ENABLED(CONFIG_BOARD_NATIVE_SIM)) {
+			continue;
+		}
+		printk("%-24s index: %llu ns, linear: %llu ns\n", cmds[i],
+		       (unsigned long long)k_cyc_to_ns_floor64(index_cycles[i]) / BENCH_ROUNDS,
+		       (unsigned long long)k_cyc_to_ns_floor64(linear_cycles[i]) / BENCH_ROUNDS);
+	}
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -3339,6 +3339,51 @@ void test_xrecvcfg_set_all_sockets(void)
 	send_at_command("AT#XCLOSE=2\r\n");
 }
 
+/*
+ * Test: AT#XRECVCFG=<handle>,<flags>,<hex>,<max_read_size>
+ * - Verifies the maximum read size is configured per socket and reported by READ command
+ * - Verifies a maximum read size larger than the receive buffers is rejected
+ */
+void test_xrecvcfg_max_read_size(void)
+{
+	const char *response;
+
+	/* Create a socket */
+	__cmock_zsock_socket_ExpectAndReturn(AF_INET, SOCK_STREAM, IPPROTO_TCP, 3);
+	__cmock_zsock_setsockopt_ExpectAnyArgsAndReturn(0); /* SO_SNDTIMEO */
+	__cmock_zsock_setsockopt_ExpectAnyArgsAndReturn(0); /* SO_POLLCB */
+	send_at_command("AT#XSOCKET=1,1,0\r\n");
+	response = get_captured_response();
+	TEST_ASSERT_TRUE(strstr(response, "#XSOCKET: 3") != NULL);
+
+	/* Default maximum read size */
+	__cmock_zsock_setsockopt_ExpectAnyArgsAndReturn(0); /* POLLCB update for receive config */
+	send_at_command("AT#XRECVCFG=3,1,0\r\n");
+	response = get_captured_response();
+	TEST_ASSERT_TRUE(strstr(response, "OK") != NULL);
+	send_at_command("AT#XRECVCFG?\r\n");
+	response = get_captured_response();
+	TEST_ASSERT_TRUE(strstr(response, "#XRECVCFG: 3,1,0,2048") != NULL);
+
+	/* Smaller maximum read size for the socket */
+	__cmock_zsock_setsockopt_ExpectAnyArgsAndReturn(0); /* POLLCB update for receive config */
+	send_at_command("AT#XRECVCFG=3,1,0,512\r\n");
+	response = get_captured_response();
+	TEST_ASSERT_TRUE(strstr(response, "OK") != NULL);
+	send_at_command("AT#XRECVCFG?\r\n");
+	response = get_captured_response();
+	TEST_ASSERT_TRUE(strstr(response, "#XRECVCFG: 3,1,0,512") != NULL);
+
+	/* Larger than the receive buffers */
+	send_at_command("AT#XRECVCFG=3,1,0,4096\r\n");
+	response = get_captured_response();
+	TEST_ASSERT_TRUE(strstr(response, "ERROR") != NULL);
+
+	/* Close socket */
+	__cmock_zsock_close_ExpectAndReturn(3, 0);
+	send_at_command("AT#XCLOSE=3\r\n");
+}
+
 extern int unity_main(void);
 
 int main(void)
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file test_http_chunked.c
+ * Unit tests for sm_http_chunked.c
+ */
+
+#include <unity.h>
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#include "sm_http_chunked.h"
+
+#define BODY_CHUNKED "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n"
+
+static struct sm_http_chunked dec;
+static uint8_t buf[256];
+static char body[256];
+static size_t body_len;
+
+/* Decode a string in reads of at most read_len bytes, collecting the body.
+ * Returns the amount of input bytes that belong to the message body, or a negative error code.
+ */
+static int decode(const char *in, size_t read_len)
+{
+	size_t in_len = strlen(in);
+	size_t total = 0;
+
+	body_len = 0;
+	while (total < in_len) {
+		size_t len = MIN(read_len, in_len - total);
+		size_t consumed;
+		int ret;
+
+		memcpy(buf, in + total, len);
+		ret = sm_http_chunked_decode(&dec, buf, len, &consumed);
+		if (ret < 0) {
+			return ret;
+		}
+		memcpy(body + body_len, buf, ret);
+		body_len += ret;
+		total += consumed;
+		if (consumed < len) {
+			break;
+		}
+	}
+	body[body_len] = '\0';
+
+	return total;
+}
+
+void setUp(void)
+{
+	sm_http_chunked_init(&dec);
+}
+
+void tearDown(void)
+{
+}
+
+void test_decode_single_read(void)
+{
+	TEST_ASSERT_EQUAL(strlen(BODY_CHUNKED), decode(BODY_CHUNKED, sizeof(buf)));
+	TEST_ASSERT_EQUAL_STRING("hello world", body);
+	TEST_ASSERT_TRUE(sm_http_chunked_done(&dec));
+}
+
+void test_decode_split_reads(void)
+{
+	/* Every split point, including inside the size lines and the final line. */
+	for (size_t read_len = 1; read_len < strlen(BODY_CHUNKED); read_len++) {
+		sm_http_chunked_init(&dec);
+		TEST_ASSERT_EQUAL(strlen(BODY_CHUNKED), decode(BODY_CHUNKED, read_len));
+		TEST_ASSERT_EQUAL_STRING("hello world", body);
+		TEST_ASSERT_TRUE(sm_http_chunked_done(&dec));
+	}
+}
+
+void test_decode_not_done(void)
+{
+	const char *in = "5\r\nhello\r\n0\r\n";
+
+	TEST_ASSERT_EQUAL(strlen(in), decode(in, sizeof(buf)));
+	TEST_ASSERT_EQUAL_STRING("hello", body);
+	TEST_ASSERT_FALSE(sm_http_chunked_done(&dec));
+}
+
+void test_decode_extensions_and_trailers(void)
+{
+	const char *in = "3;name=\"value\"\r\nabc\r\nA \r\n0123456789\r\n0\r\nExpires: 0\r\n\r\n";
+
+	TEST_ASSERT_EQUAL(strlen(in), decode(in, sizeof(buf)));
+	TEST_ASSERT_EQUAL_STRING("abc0123456789", body);
+	TEST_ASSERT_TRUE(sm_http_chunked_done(&dec));
+}
+
+void test_decode_stops_at_end(void)
+{
+	TEST_ASSERT_EQUAL(strlen(BODY_CHUNKED), decode(BODY_CHUNKED "HTTP/1.1 200 OK\r\n", 64));
+	TEST_ASSERT_EQUAL_STRING("hello world", body);
+	TEST_ASSERT_TRUE(sm_http_chunked_done(&dec));
+}
+
+void test_decode_invalid(void)
+{
+	TEST_ASSERT_EQUAL(-EBADMSG, decode("x\r\n", sizeof(buf)));
+
+	sm_http_chunked_init(&dec);
+	TEST_ASSERT_EQUAL(-EBADMSG, decode("\r\n", sizeof(buf)));
+
+	sm_http_chunked_init(&dec);
+	TEST_ASSERT_EQUAL(-EBADMSG, decode("3\r\nabcd\r\n", sizeof(buf)));
+
+	sm_http_chunked_init(&dec);
+	TEST_ASSERT_EQUAL(-EBADMSG, decode("3\nabc\r\n", sizeof(buf)));
+
+	sm_http_chunked_init(&dec);
+	TEST_ASSERT_EQUAL(-EBADMSG, decode("123456789\r\n", sizeof(buf)));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2026 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file test_http_header.c
+ * Unit tests for sm_http_header.c
+ */
+
+#include <unity.h>
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/util.h>
+
+#include "sm_http_header.h"
+
+#define HEADER "HTTP/1.1 200 OK\r\n" \
+	       "Content-Type: text/plain\r\n" \
+	       "content-length:  1234 \r\n" \
+	       "Connection: keep-alive, Close\r\n" \
+	       "Keep-Alive: max=100, timeout=5\r\n" \
+	       "\r\n"
+
+static struct sm_http_header parser;
+static char fields[256];
+
+static void field_cb(const char *name, size_t name_len, const char *value, size_t value_len,
+		     void *user_data)
+{
+	size_t len = strlen(fields);
+
+	snprintf(fields + len, sizeof(fields) - len, "%.*s=%.*s;", (int)name_len, name,
+		 (int)value_len, value);
+}
+
+/* Parse a string given in reads of at most read_len bytes. Returns the last parse result. */
+static int parse(const char *in, size_t read_len)
+{
+	size_t in_len = strlen(in);
+	size_t len = 0;
+	int ret = 0;
+
+	while (len < in_len && ret == 0) {
+		len += MIN(read_len, in_len - len);
+		ret = sm_http_header_parse(&parser, in, len);
+	}
+
+	return ret;
+}
+
+void setUp(void)
+{
+	fields[0] = '\0';
+	sm_http_header_init(&parser, field_cb, NULL);
+}
+
+void tearDown(void)
+{
+}
+
+void test_parse_single_read(void)
+{
+	TEST_ASSERT_EQUAL(strlen(HEADER), parse(HEADER "body", 256));
+	TEST_ASSERT_EQUAL(200, parser.status_code);
+	TEST_ASSERT_EQUAL(1234, parser.content_length);
+	TEST_ASSERT_TRUE(parser.connection_close);
+	TEST_ASSERT_EQUAL(5, parser.keep_alive_timeout);
+	TEST_ASSERT_FALSE(parser.chunked);
+	TEST_ASSERT_EQUAL_STRING("Content-Type=text/plain;content-length=1234;"
+				 "Connection=keep-alive, Close;Keep-Alive=max=100, timeout=5;",
+				 fields);
+}
+
+void test_parse_split_reads(void)
+{
+	/* Every split point, including inside the line breaks. */
+	for (size_t read_len = 1; read_len < strlen(HEADER); read_len++) {
+		setUp();
+		TEST_ASSERT_EQUAL(strlen(HEADER), parse(HEADER, read_len));
+		TEST_ASSERT_EQUAL(200, parser.status_code);
+		TEST_ASSERT_EQUAL(1234, parser.content_length);
+		TEST_ASSERT_TRUE(parser.connection_close);
+		TEST_ASSERT_EQUAL(5, parser.keep_alive_timeout);
+	}
+}
+
+void test_parse_incomplete(void)
+{
+	TEST_ASSERT_EQUAL(0, parse("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n", 256));
+	TEST_ASSERT_EQUAL(404, parser.status_code);
+	TEST_ASSERT_EQUAL(0, parser.content_length);
+	TEST_ASSERT_EQUAL(-1, parser.keep_alive_timeout);
+	TEST_ASSERT_FALSE(parser.connection_close);
+}
+
+void test_parse_chunked(void)
+{
+	const char *in = "HTTP/1.1 200 OK\r\nTransfer-Encoding: gzip, chunked\r\n\r\n";
+
+	TEST_ASSERT_EQUAL(strlen(in), parse(in, 256));
+	TEST_ASSERT_TRUE(parser.chunked);
+	TEST_ASSERT_EQUAL(-1, parser.content_length);
+
+	setUp();
+	in = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked, gzip\r\n\r\n";
+	TEST_ASSERT_EQUAL(strlen(in), parse(in, 256));
+	TEST_ASSERT_FALSE(parser.chunked);
+}
+
+void test_parse_values_not_in_other_fields(void)
+{
+	const char *in = "HTTP/1.0 204 No Content\n"
+			 "X-Note: Connection: close\n"
+			 "X-Length: Content-Length: 5\n"
+			 "\n";
+
+	TEST_ASSERT_EQUAL(strlen(in), parse(in, 256));
+	TEST_ASSERT_EQUAL(204, parser.status_code);
+	TEST_ASSERT_EQUAL(-1, parser.content_length);
+	TEST_ASSERT_FALSE(parser.connection_close);
+}
+
+void test_parse_invalid(void)
+{
+	TEST_ASSERT_EQUAL(-EBADMSG, parse("HTTP/2 200\r\n\r\n", 256));
+
+	setUp();
+	TEST_ASSERT_EQUAL(-EBADMSG, parse("HTTP/1.1 20x OK\r\n\r\n", 256));
+
+	setUp();
+	TEST_ASSERT_EQUAL(-EBADMSG, parse("\r\n\r\n", 256));
+
+	setUp();
+	TEST_ASSERT_EQUAL(0, parse("HTTP/1.1 200 OK\r\nContent-Length: 1x\r\nInvalid\r\n", 256));
+	TEST_ASSERT_EQUAL(-1, parser.content_length);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}